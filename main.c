@@ -1,892 +1,472 @@
-#include <stdio.h>
-#include <stdlib.h>
-#include <stdbool.h>
-#include <string.h>
-#include <time.h>
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
-#include <limits.h>
-
-#define INF INT_MAX
+#include "maze_core.h"
+#include "maze_file.h"
+#include "maze_stream.h"
 
 #define CELL_SIZE 35
-#define MAX_POINTS 1500 // 1 pour début, 1 pour fin, 100 pour les mots (par exemple) exactement dans le calcul de la distance !!!!
-
-typedef struct Node
-{
-    int x, y;
-    struct Node **neighbors;
-    int neighbor_count;
-    char letter;
-    bool visited;
-    bool is_part_of_word;
-} Node;
 
-typedef struct
-{
-    const char *word; // Le mot en question
-    int startX;       // Coordonnée X de départ
-    int startY;       // Coordonnée Y de départ
-    int endX;
-    int endY;
-    int direction; // 0 pour horizontal, 1 pour vertical
-    int length;    // Longueur du mot
-} WordPosition;
+// Glyph atlas: every printable ASCII character is rasterized once into a single texture, so a
+// letter on the board is one SDL_RenderCopy instead of a rasterization and an upload per frame
+#define GLYPH_FIRST 32          // Space
+#define GLYPH_LAST 126          // Tilde
+#define GLYPH_ATLAS_WIDTH 1024  // Glyphs are laid out in rows of this width
 
 typedef struct
 {
-    Node **nodes;
-    int node_count;
-    Node *start;
-    Node *end;
-} Graph;
+    SDL_Texture *texture;
+    int width, height;               // Size of the texture
+    SDL_Rect glyphs[GLYPH_LAST + 1]; // Where each character is in the texture, empty if it has none
+} GlyphAtlas;
 
-typedef struct
-{
-    int x, y;
-    int score;
-    char path[200]; // Path to store collected letters
-} Player;
+long textures_created = 0; // Textures created since startup, reported by --frame-stats
 
-typedef struct PriorityQueue
+GlyphAtlas *create_glyph_atlas(SDL_Renderer *renderer, TTF_Font *font, SDL_Color color)
 {
-    Node *nodes[MAX_POINTS];
-    int distances[MAX_POINTS];
-    int size;
-} PriorityQueue;
-
-// Create a node
-Node *create_node(int x, int y)
-{
-    Node *node = (Node *)malloc(sizeof(Node));
-    if (!node)
-    {
-        printf("Memory allocation error for node.\n");
-        exit(1);
-    }
-    node->x = x;
-    node->y = y;
-    node->neighbor_count = 0;
-    node->neighbors = (Node **)malloc(8 * sizeof(Node *));
-    node->letter = ' '; // Initialize as empty space
-    node->visited = false;
-    node->is_part_of_word = false;
-
-    if (!node->neighbors)
+    GlyphAtlas *atlas = (GlyphAtlas *)calloc(1, sizeof(GlyphAtlas));
+    if (!atlas)
     {
-        printf("Memory allocation error for neighbors.\n");
-        free(node);
-        exit(1);
+        printf("Memory allocation failed.\n");
+        return NULL;
     }
-    return node;
-}
-
-// Create graph
-Graph *create_graph(int GRID_SIZE)
-{
-    Graph *graph = (Graph *)malloc(sizeof(Graph));
-    graph->nodes = (Node **)malloc(GRID_SIZE * GRID_SIZE * sizeof(Node *));
-    graph->node_count = 0;
-    graph->start = NULL;
-    graph->end = NULL;
-    return graph;
-}
-
-// Add node to graph
-void add_node(Graph *graph, Node *node)
-{
-    graph->nodes[graph->node_count++] = node;
-}
 
-// Add an edge
-void add_edge(Node *node1, Node *node2)
-{
-    // Avoid self-loops
-    if (node1 == node2)
+    // Lay the glyphs out in rows
+    SDL_Surface *glyphs[GLYPH_LAST + 1] = {NULL};
+    int x = 0, y = 0, row_height = 0;
+    for (int c = GLYPH_FIRST; c <= GLYPH_LAST; c++)
     {
-        // printf("Skipping self-loop at (%d, %d)\n", node1->x, node1->y);
-        return;
-    }
+        glyphs[c] = TTF_RenderGlyph_Blended(font, c, color);
+        if (!glyphs[c])
+            continue;
 
-    // Check if node2 is already in node1's neighbors
-    int already_connected = 0;
-    for (int i = 0; i < node1->neighbor_count; i++)
-    {
-        if (node1->neighbors[i] == node2)
+        if (x + glyphs[c]->w > GLYPH_ATLAS_WIDTH)
         {
-            already_connected = 1;
-            break;
+            x = 0;
+            y += row_height;
+            row_height = 0;
         }
+        atlas->glyphs[c] = (SDL_Rect){x, y, glyphs[c]->w, glyphs[c]->h};
+        x += glyphs[c]->w;
+        if (glyphs[c]->h > row_height)
+            row_height = glyphs[c]->h;
     }
 
-    // Check if node1 is already in node2's neighbors
-    for (int i = 0; i < node2->neighbor_count; i++)
+    // Copy them with their alpha into one sheet, uploaded once
+    SDL_Surface *sheet = SDL_CreateRGBSurfaceWithFormat(0, GLYPH_ATLAS_WIDTH, y + row_height, 32, SDL_PIXELFORMAT_RGBA32);
+    for (int c = GLYPH_FIRST; c <= GLYPH_LAST; c++)
     {
-        if (node2->neighbors[i] == node1)
-        {
-            already_connected = 1;
-            break;
-        }
-    }
+        if (!glyphs[c])
+            continue;
 
-    // If already connected, skip adding the edge
-    if (already_connected)
-    {
-        // printf("Edge between (%d, %d) and (%d, %d) already exists. Skipping.\n",
-        //        node1->x, node1->y, node2->x, node2->y);
-        return;
-    }
-
-    // Add node2 to node1's neighbors
-    node1->neighbors = (Node **)realloc(node1->neighbors, (node1->neighbor_count + 1) * sizeof(Node *));
-    node1->neighbors[node1->neighbor_count++] = node2;
-
-    // Add node1 to node2's neighbors
-    node2->neighbors = (Node **)realloc(node2->neighbors, (node2->neighbor_count + 1) * sizeof(Node *));
-    node2->neighbors[node2->neighbor_count++] = node1;
-
-    // printf("Added edge between (%d, %d) and (%d, %d)\n", node1->x, node1->y, node2->x, node2->y);
-}
-
-void print_neighbors(Graph *graph, int GRID_SIZE)
-{
-    for (int x = 0; x < GRID_SIZE; x++)
-    {
-        for (int y = 0; y < GRID_SIZE; y++)
+        if (sheet)
         {
-            Node *node = graph->nodes[x * GRID_SIZE + y];
-            printf("Node (%d, %d) Letter %c has %d neighbors: ", x, y, node->letter, node->neighbor_count);
-            for (int i = 0; i < node->neighbor_count; i++)
-            {
-                printf("(%d, %d) ", node->neighbors[i]->x, node->neighbors[i]->y);
-            }
-            printf("\n");
+            SDL_Rect target = atlas->glyphs[c]; // SDL_BlitSurface may clip it
+            SDL_SetSurfaceBlendMode(glyphs[c], SDL_BLENDMODE_NONE);
+            SDL_BlitSurface(glyphs[c], NULL, sheet, &target);
         }
+        SDL_FreeSurface(glyphs[c]);
     }
-}
-
-// Initialize the graph
-void initialize_graph(Graph *graph, int GRID_SIZE)
-{
-
-    for (int x = 0; x < GRID_SIZE; x++)
+    if (sheet)
     {
-        for (int y = 0; y < GRID_SIZE; y++)
-        {
-            Node *node = create_node(x, y);
-            add_node(graph, node);
-        }
+        atlas->texture = SDL_CreateTextureFromSurface(renderer, sheet);
+        atlas->width = sheet->w;
+        atlas->height = sheet->h;
+        textures_created++;
+        SDL_FreeSurface(sheet);
     }
 
-    for (int x = 0; x < GRID_SIZE; x++)
+    if (!atlas->texture)
     {
-        for (int y = 0; y < GRID_SIZE; y++)
-        {
-            Node *node = graph->nodes[x * GRID_SIZE + y];
-
-            if (x > 0)
-                add_edge(node, graph->nodes[(x - 1) * GRID_SIZE + y]);
-            if (x < GRID_SIZE - 1)
-                add_edge(node, graph->nodes[(x + 1) * GRID_SIZE + y]);
-            if (y > 0)
-                add_edge(node, graph->nodes[x * GRID_SIZE + (y - 1)]);
-            if (y < GRID_SIZE - 1)
-                add_edge(node, graph->nodes[x * GRID_SIZE + (y + 1)]);
-
-            // Diagonales
-            if (x > 0 && y > 0)
-                add_edge(node, graph->nodes[(x - 1) * GRID_SIZE + (y - 1)]); // haut-gauche
-            if (x > 0 && y < GRID_SIZE - 1)
-                add_edge(node, graph->nodes[(x - 1) * GRID_SIZE + (y + 1)]); // haut-droit
-            if (x < GRID_SIZE - 1 && y > 0)
-                add_edge(node, graph->nodes[(x + 1) * GRID_SIZE + (y - 1)]); // bas-gauche
-            if (x < GRID_SIZE - 1 && y < GRID_SIZE - 1)
-                add_edge(node, graph->nodes[(x + 1) * GRID_SIZE + (y + 1)]); // bas-droit
-        }
+        printf("Erreur : impossible de créer l'atlas des lettres\n");
+        free(atlas);
+        return NULL;
     }
+    return atlas;
 }
 
-// Set start and end points
-void set_start_end(Graph *graph)
+void free_glyph_atlas(GlyphAtlas *atlas)
 {
-    Node *valid_nodes[graph->node_count]; // Array to store valid nodes
-    int valid_count = 0;
-
-    // Collect all valid nodes (not walls, empty spaces, or part of a word)
-    for (int i = 0; i < graph->node_count; i++)
-    {
-        // printf("Node letter: %c\n and is_part_of_word: %d\n", graph->nodes[i]->letter, graph->nodes[i]->is_part_of_word);
-        if (graph->nodes[i]->letter != '#' && graph->nodes[i]->letter != ' ' && !graph->nodes[i]->is_part_of_word)
-        {
-            valid_nodes[valid_count++] = graph->nodes[i];
-        }
-    }
-
-    // Ensure there are at least 2 valid nodes (start and end)
-    if (valid_count < 2)
-    {
-        // printf("Error: Not enough valid nodes for start and end!\n");
+    if (!atlas)
         return;
-    }
-
-    // Select start position randomly from valid nodes
-    graph->start = valid_nodes[rand() % valid_count];
 
-    // Select end position ensuring minimum distance of 5
-    do
-    {
-        graph->end = valid_nodes[rand() % valid_count];
-    } while (graph->end == graph->start ||
-             abs(graph->end->x - graph->start->x) + abs(graph->end->y - graph->start->y) < 5);
+    SDL_DestroyTexture(atlas->texture);
+    free(atlas);
+}
 
-    printf("Start: (%d, %d), End: (%d, %d)\n", graph->start->x, graph->start->y, graph->end->x, graph->end->y);
+// Geometry of the board, submitted in a few calls instead of a few per cell: the cells grouped by
+// color for SDL_RenderFillRects / SDL_RenderDrawRects, and every letter as a textured quad of a
+// single SDL_RenderGeometry call. The buffers grow with the board and are reused between draws.
+typedef struct
+{
+    int capacity;          // Cells
+    SDL_Rect *cells;       // Every cell, for the grid lines
+    SDL_Rect *walls;       // Filled dark gray
+    SDL_Rect *floors;      // Filled light gray
+    SDL_Vertex *vertices;  // 4 per letter
+    int *indices;          // 6 per letter, the same two triangles for every quad
+} BoardBatch;
+
+void free_board_batch(BoardBatch *batch)
+{
+    free(batch->cells);
+    free(batch->walls);
+    free(batch->floors);
+    free(batch->vertices);
+    free(batch->indices);
+    *batch = (BoardBatch){0};
 }
 
-// Charge un dictionnaire de mots depuis un fichier
-int load_words(const char *filename, char words[][20], int max_words)
+// Make room for the given number of cells. Returns false if the memory is missing.
+bool reserve_board_batch(BoardBatch *batch, int cells)
 {
-    FILE *file = fopen(filename, "r");
-    if (!file)
+    if (batch->capacity >= cells)
+        return true;
+
+    free_board_batch(batch);
+    batch->cells = (SDL_Rect *)malloc(cells * sizeof(SDL_Rect));
+    batch->walls = (SDL_Rect *)malloc(cells * sizeof(SDL_Rect));
+    batch->floors = (SDL_Rect *)malloc(cells * sizeof(SDL_Rect));
+    batch->vertices = (SDL_Vertex *)malloc((size_t)cells * 4 * sizeof(SDL_Vertex));
+    batch->indices = (int *)malloc((size_t)cells * 6 * sizeof(int));
+    if (!batch->cells || !batch->walls || !batch->floors || !batch->vertices || !batch->indices)
     {
-        printf("Erreur : impossible d'ouvrir le fichier %s\n", filename);
-        return 0;
+        free_board_batch(batch);
+        return false;
     }
 
-    int count = 0;
-    while (fscanf(file, "%19s", words[count]) == 1 && count < max_words)
+    for (int q = 0; q < cells; q++)
     {
-        count++;
+        int *quad = batch->indices + 6 * q;
+        quad[0] = 4 * q;
+        quad[1] = 4 * q + 1;
+        quad[2] = 4 * q + 2;
+        quad[3] = 4 * q + 2;
+        quad[4] = 4 * q + 1;
+        quad[5] = 4 * q + 3;
     }
-
-    fclose(file);
-    return count;
+    batch->capacity = cells;
+    return true;
 }
 
-int can_place_word(Graph *graph, const char *word, int x, int y, int horizontal, int GRID_SIZE)
+// Draw what never changes during a game (walls, cells with their letters and grid lines) for the
+// cols cells from first_col of row_count rows, with the first cell at the top left corner. rows
+// holds the first node of each row, NULL for a row that is gone (drawn as walls).
+void draw_static_layer(SDL_Renderer *renderer, Node *const *rows, GlyphAtlas *atlas, BoardBatch *batch,
+                       int first_col, int row_count, int cols)
 {
-    int len = strlen(word);
-    if (horizontal)
+    if (!reserve_board_batch(batch, row_count * cols))
     {
-        if (y + len > GRID_SIZE)
-            return 0;
-        for (int i = 0; i < len; i++)
-        {
-            Node *node = graph->nodes[x * GRID_SIZE + y + i];
-            if (node->letter != ' ' && node->letter != word[i])
-                return 0;
-        }
-    }
-    else
-    {
-        if (x + len > GRID_SIZE)
-            return 0;
-        for (int i = 0; i < len; i++)
-        {
-            Node *node = graph->nodes[(x + i) * GRID_SIZE + y];
-            if (node->letter != ' ' && node->letter != word[i])
-                return 0;
-        }
+        printf("Memory allocation failed.\n");
+        return;
     }
-    return 1;
-}
-
-int try_place_word(Graph *graph, const char *word, WordPosition *word_positions, int *word_count, int GRID_SIZE)
-{
-    int len = strlen(word);
-    int attempts = 100;
 
-    while (attempts-- > 0)
+    int cell_count = 0, wall_count = 0, floor_count = 0, letter_count = 0;
+    for (int i = 0; i < row_count; i++)
     {
-        int horizontal = rand() % 2;
-        int x = rand() % GRID_SIZE;
-        int y = rand() % GRID_SIZE;
-
-        if (can_place_word(graph, word, x, y, horizontal, GRID_SIZE))
+        for (int j = 0; j < cols; j++)
         {
-            // Place the word on the grid
-            for (int i = 0; i < len; i++)
-            {
-                Node *node = graph->nodes[(horizontal ? x : x + i) * GRID_SIZE + (horizontal ? y + i : y)];
-                node->letter = word[i];
-                node->is_part_of_word = true;
-            }
-
-            // Save the position and information of the word
-            word_positions[*word_count].word = word;
-            word_positions[*word_count].direction = horizontal;
-            word_positions[*word_count].length = len;
-
-            // Store the start position (x, y) of the word
-            word_positions[*word_count].startX = x;
-            word_positions[*word_count].startY = y;
+            Node *node = rows[i] ? &rows[i][first_col + j] : NULL;
+            SDL_Rect cell = {j * CELL_SIZE, i * CELL_SIZE, CELL_SIZE, CELL_SIZE};
+            batch->cells[cell_count++] = cell;
 
-            // Calculate the end position based on direction and word length
-            if (horizontal)
+            if (!node || node->letter == '#')
             {
-                word_positions[*word_count].endX = x;
-                word_positions[*word_count].endY = y + len - 1;
-            }
-            else
-            {
-                word_positions[*word_count].endX = x + len - 1;
-                word_positions[*word_count].endY = y;
+                batch->walls[wall_count++] = cell;
+                continue;
             }
+            batch->floors[floor_count++] = cell;
 
-            // Increment the word count
-            (*word_count)++;
+            // Quad of the letter (if any), centered in the cell, with its glyph from the atlas
+            unsigned char letter = node->letter;
+            if (letter == ' ' || letter > GLYPH_LAST || atlas->glyphs[letter].w == 0)
+                continue;
 
-            return 1;
+            SDL_Rect *glyph = &atlas->glyphs[letter];
+            float left = cell.x + (CELL_SIZE - glyph->w) / 2, top = cell.y + (CELL_SIZE - glyph->h) / 2;
+            float u0 = (float)glyph->x / atlas->width, u1 = (float)(glyph->x + glyph->w) / atlas->width;
+            float v0 = (float)glyph->y / atlas->height, v1 = (float)(glyph->y + glyph->h) / atlas->height;
+            SDL_Vertex *quad = batch->vertices + 4 * letter_count++;
+            quad[0] = (SDL_Vertex){{left, top}, {255, 255, 255, 255}, {u0, v0}};
+            quad[1] = (SDL_Vertex){{left + glyph->w, top}, {255, 255, 255, 255}, {u1, v0}};
+            quad[2] = (SDL_Vertex){{left, top + glyph->h}, {255, 255, 255, 255}, {u0, v1}};
+            quad[3] = (SDL_Vertex){{left + glyph->w, top + glyph->h}, {255, 255, 255, 255}, {u1, v1}};
         }
     }
-    return 0;
-}
 
-void place_words(Graph *graph, const char *words[], WordPosition *word_positions, int *word_count, int word_count_total, int GRID_SIZE)
-{
-    for (int i = 0; i < word_count_total; i++)
-    {
-        if (!try_place_word(graph, words[i], word_positions, word_count, GRID_SIZE))
-        {
-            printf("⚠️ Impossible de placer le mot: %s\n", words[i]);
-        }
-    }
-}
+    // Walls (dark gray) and empty cells (light gray)
+    SDL_SetRenderDrawColor(renderer, 50, 50, 50, 255);
+    SDL_RenderFillRects(renderer, batch->walls, wall_count);
+    SDL_SetRenderDrawColor(renderer, 220, 220, 220, 255);
+    SDL_RenderFillRects(renderer, batch->floors, floor_count);
 
-// Initialize the player
-void initialize_player(Player *player, Graph *graph)
-{
-    player->x = graph->start->x;
-    player->y = graph->start->y;
-    player->score = 0;
+    // Letters
+    SDL_RenderGeometry(renderer, atlas->texture, batch->vertices, letter_count * 4, batch->indices, letter_count * 6);
+
+    // Grid lines (light gray)
+    SDL_SetRenderDrawColor(renderer, 200, 200, 200, 255);
+    SDL_RenderDrawRects(renderer, batch->cells, cell_count);
 }
 
-// Move the player
-// Update the move_player function
-void move_player(Player *player, Graph *graph, int dx, int dy, int GRID_SIZE)
+// View of the board: which part of it the window shows, and how big
+#define MIN_ZOOM 0.25f
+#define MAX_ZOOM 2.0f
+
+typedef struct
 {
-    int new_x = player->x + dx;
-    int new_y = player->y + dy;
+    float x, y;        // Board pixel at the top left corner of the window
+    float zoom;        // Window pixels per board pixel
+    int width, height; // Window size
+} Camera;
 
-    for (int i = 0; i < graph->node_count; i++)
-    {
-        Node *node = graph->nodes[i];
-        if (node->x == new_x && node->y == new_y && node->letter != '#')
-        {
-            player->x = new_x;
-            player->y = new_y;
-            Node *currentNode = graph->nodes[player->x * GRID_SIZE + player->y];
-            currentNode->visited = true;
-            // Check if the player collects a letter
-            if (node->letter != ' ')
-            {
-                // player->score += 10;  // Increase score when collecting a letter
-                // node->letter = ' ';
-                // add the letter to the player path
-                player->path[strlen(player->path)] = node->letter;
-            }
-            break;
-        }
-    }
+// Window rectangle of a board rectangle. Both edges are rounded, so neighbors do not leave gaps.
+SDL_Rect camera_rect(Camera *camera, int x, int y, int w, int h)
+{
+    int left = (int)SDL_floorf((x - camera->x) * camera->zoom + 0.5f);
+    int top = (int)SDL_floorf((y - camera->y) * camera->zoom + 0.5f);
+    int right = (int)SDL_floorf((x + w - camera->x) * camera->zoom + 0.5f);
+    int bottom = (int)SDL_floorf((y + h - camera->y) * camera->zoom + 0.5f);
+    return (SDL_Rect){left, top, right - left, bottom - top};
 }
 
-// Function to remove an edge between two nodes
-void remove_edge(Node *node1, Node *node2)
+// Keep the player's cell in the middle of the window, without showing past the edges of a board of
+// rows x cols cells (a board smaller than the window is centered)
+void follow_player(Camera *camera, Player *player, int rows, int cols)
 {
-    for (int i = 0; i < node1->neighbor_count; i++)
-    {
-        if (node1->neighbors[i] == node2)
-        {
-            // Shift neighbors left to remove the connection
-            for (int j = i; j < node1->neighbor_count - 1; j++)
-            {
-                node1->neighbors[j] = node1->neighbors[j + 1];
-            }
-            node1->neighbor_count--;
-            break;
-        }
-    }
+    float board_width = (float)cols * CELL_SIZE, board_height = (float)rows * CELL_SIZE;
+    float view_width = camera->width / camera->zoom, view_height = camera->height / camera->zoom;
 
-    for (int i = 0; i < node2->neighbor_count; i++)
-    {
-        if (node2->neighbors[i] == node1)
-        {
-            for (int j = i; j < node2->neighbor_count - 1; j++)
-            {
-                node2->neighbors[j] = node2->neighbors[j + 1];
-            }
-            node2->neighbor_count--;
-            break;
-        }
-    }
+    camera->x = player->y * CELL_SIZE + CELL_SIZE / 2 - view_width / 2;
+    camera->y = player->x * CELL_SIZE + CELL_SIZE / 2 - view_height / 2;
+    camera->x = board_width <= view_width ? (board_width - view_width) / 2 : SDL_clamp(camera->x, 0, board_width - view_width);
+    camera->y = board_height <= view_height ? (board_height - view_height) / 2 : SDL_clamp(camera->y, 0, board_height - view_height);
 }
 
-// Function to add a wall by removing edges and marking the grid
-void add_wall(Graph *graph, int x1, int y1, int x2, int y2, int GRID_SIZE){
-    int passage_x = x1 + rand() % (x2 - x1 + 1);
-    int passage_y = y1 + rand() % (y2 - y1 + 1);
-    if (x1 == x2){ // Vertical wall
-        for (int y = y1; y <= y2; y++){
-            if (y != passage_y){ // Leave a passage
-                Node *node = graph->nodes[x1 * GRID_SIZE + y];
-                if (node->letter == ' '){ // Only mark as a wall if it's empty
-                    node->letter = '#';
-                    // Remove edges to disconnect from neighbors
-                    if (x1 > 0)
-                        remove_edge(node, graph->nodes[(x1 - 1) * GRID_SIZE + y]); // Left
-                    if (x1 < GRID_SIZE - 1)
-                        remove_edge(node, graph->nodes[(x1 + 1) * GRID_SIZE + y]); // Right
-                    if (y > 0)
-                        remove_edge(node, graph->nodes[x1 * GRID_SIZE + (y - 1)]); // Up
-                    if (y < GRID_SIZE - 1)
-                        remove_edge(node, graph->nodes[x1 * GRID_SIZE + (y + 1)]); // Down
-                    if (x1 > 0 && y > 0)
-                        remove_edge(node, graph->nodes[(x1 - 1) * GRID_SIZE + (y - 1)]); // Top-left diagonal
-                    if (x1 > 0 && y < GRID_SIZE - 1)
-                        remove_edge(node, graph->nodes[(x1 - 1) * GRID_SIZE + (y + 1)]); // Top-right diagonal
-                    if (x1 < GRID_SIZE - 1 && y > 0)
-                        remove_edge(node, graph->nodes[(x1 + 1) * GRID_SIZE + (y - 1)]); // Bottom-left diagonal
-                    if (x1 < GRID_SIZE - 1 && y < GRID_SIZE - 1)
-                        remove_edge(node, graph->nodes[(x1 + 1) * GRID_SIZE + (y + 1)]); // Bottom-right diagonal
-                }
-            }
-        }
-    }
-    else if (y1 == y2)
-    { // Horizontal wall
-        for (int x = x1; x <= x2; x++)
-        {
-            if (x != passage_x)
-            { // Leave a passage
-                Node *node = graph->nodes[x * GRID_SIZE + y1];
-                if (node->letter == ' ')
-                { // Only mark as a wall if it's empty
-                    node->letter = '#';
-
-                    // Remove edges to disconnect from neighbors
-                    if (x > 0)
-                        remove_edge(node, graph->nodes[(x - 1) * GRID_SIZE + y1]); // Left
-                    if (x < GRID_SIZE - 1)
-                        remove_edge(node, graph->nodes[(x + 1) * GRID_SIZE + y1]); // Right
-                    if (y1 > 0)
-                        remove_edge(node, graph->nodes[x * GRID_SIZE + (y1 - 1)]); // Up
-                    if (y1 < GRID_SIZE - 1)
-                        remove_edge(node, graph->nodes[x * GRID_SIZE + (y1 + 1)]); // Down
-                    if (x > 0 && y1 > 0)
-                        remove_edge(node, graph->nodes[(x - 1) * GRID_SIZE + (y1 - 1)]); // Top-left diagonal
-                    if (x < GRID_SIZE - 1 && y1 > 0)
-                        remove_edge(node, graph->nodes[(x + 1) * GRID_SIZE + (y1 - 1)]); // Top-right diagonal
-                    if (x > 0 && y1 < GRID_SIZE - 1)
-                        remove_edge(node, graph->nodes[(x - 1) * GRID_SIZE + (y1 + 1)]); // Bottom-left diagonal
-                    if (x < GRID_SIZE - 1 && y1 < GRID_SIZE - 1)
-                        remove_edge(node, graph->nodes[(x + 1) * GRID_SIZE + (y1 + 1)]); // Bottom-right diagonal
-                }
-            }
-        }
-    }
-}
-// add random LETTERS to the graph
-void add_random_letters(Graph *graph, int GRID_SIZE)
-{
-    for (int i = 0; i < GRID_SIZE; i++)
-    {
-        for (int j = 0; j < GRID_SIZE; j++)
-        {
-            Node *node = graph->nodes[i * GRID_SIZE + j];
-            if (node->letter == ' ')
-            {
-                node->letter = 'A' + rand() % 26;
-            }
-        }
-    }
-}
+// Board layers, in chunks of CHUNK_CELLS x CHUNK_CELLS cells so only what the window shows is ever
+// drawn. Each chunk has a render target with its static layer, and a streaming texture with one
+// pixel per cell for the visited overlay, updated one cell at a time as the player moves. Chunks
+// are built when they first come into view and the least recently used one is reused when the
+// cache is full. A frame costs two copies per visible chunk, whatever the grid size.
+#define CHUNK_CELLS 32
+#define CHUNK_CACHE_SIZE 16 // Enough for the chunks in view at the smallest zoom (see camera_min_zoom)
 
-// Recursive function to divide the graph into sections using walls
-void divide_graph(Graph *graph, int startX, int startY, int endX, int endY, int GRID_SIZE)
+typedef struct
 {
-    if (endX - startX < 2 || endY - startY < 2)
-    {
-        return; // Stop when sections are too small
-    }
+    int row, col;         // Chunk coordinates, -1 when the chunk holds nothing
+    SDL_Texture *tiles;   // CHUNK_CELLS * CELL_SIZE square, render target
+    SDL_Texture *visited; // CHUNK_CELLS square, one RGBA pixel per cell
+    unsigned long last_used;
+} Chunk;
 
-    if (rand() % 2 == 0)
-    { // Vertical division
-        int divideX = startX + rand() % (endX - startX - 1) + 1;
-        add_wall(graph, divideX, startY, divideX, endY, GRID_SIZE);        // Add vertical wall
-        divide_graph(graph, startX, startY, divideX - 1, endY, GRID_SIZE); // Left section
-        divide_graph(graph, divideX + 1, startY, endX, endY, GRID_SIZE);   // Right section
-    }
-    else
-    { // Horizontal division
-        int divideY = startY + rand() % (endY - startY - 1) + 1;
-        add_wall(graph, startX, divideY, endX, divideY, GRID_SIZE);        // Add horizontal wall
-        divide_graph(graph, startX, startY, endX, divideY - 1, GRID_SIZE); // Top section
-        divide_graph(graph, startX, divideY + 1, endX, endY, GRID_SIZE);
-        // Bottom section
-    }
+typedef struct
+{
+    int rows, cols; // Board size in cells, rows is INT_MAX for an endless maze
+    SDL_Renderer *renderer;
+    Graph *graph;
+    MazeStream *stream; // Endless maze, drawn instead of graph
+    GlyphAtlas *atlas;
+    Chunk chunks[CHUNK_CACHE_SIZE];
+    unsigned long uses;
+    BoardBatch batch; // Geometry buffers for drawing a chunk
+} MazeLayers;
+
+static const Uint8 VISITED_PIXEL[4] = {255, 165, 0, 100}; // Orange with transparency
+static const Uint8 UNVISITED_PIXEL[4] = {0, 0, 0, 0};
+
+// Smallest zoom that keeps the chunks in view (at most 3 x 3) within the cache
+float camera_min_zoom(Camera *camera)
+{
+    int larger = camera->width > camera->height ? camera->width : camera->height;
+    float zoom = larger / (2.0f * CHUNK_CELLS * CELL_SIZE);
+    return zoom > MIN_ZOOM ? zoom : MIN_ZOOM;
 }
 
-// Function to push a node into the priority queue
-void push(PriorityQueue *pq, Node *node, int distance)
+// Zoom by factor, within the allowed range (follow_player then recenters the view)
+void zoom_camera(Camera *camera, float factor)
 {
-    pq->nodes[pq->size] = node;
-    pq->distances[pq->size] = distance;
-    pq->size++;
+    camera->zoom = SDL_clamp(camera->zoom * factor, camera_min_zoom(camera), MAX_ZOOM);
 }
 
-// Function to pop the node with the shortest distance
-Node *pop(PriorityQueue *pq)
+// Forget every chunk (their textures are kept): needed when the renderer loses its target textures
+void invalidate_chunks(MazeLayers *layers)
 {
-    if (pq->size == 0)
-        return NULL;
-
-    int minIndex = 0;
-    for (int i = 1; i < pq->size; i++)
+    for (int c = 0; c < CHUNK_CACHE_SIZE; c++)
     {
-        if (pq->distances[i] < pq->distances[minIndex])
-        {
-            minIndex = i;
-        }
+        layers->chunks[c].row = -1;
+        layers->chunks[c].col = -1;
     }
-
-    Node *minNode = pq->nodes[minIndex];
-
-    // Remove the node from the queue
-    for (int i = minIndex; i < pq->size - 1; i++)
-    {
-        pq->nodes[i] = pq->nodes[i + 1];
-        pq->distances[i] = pq->distances[i + 1];
-    }
-    pq->size--;
-
-    return minNode;
 }
-char *enlever_premier_dernier(const char *source)
-{
-    int longueur = strlen(source);
 
-    // Vérifier si la chaîne est trop courte pour être traitée
-    if (longueur <= 2)
-    {
-        return strdup(""); // Retourner une chaîne vide
-    }
+void free_maze_layers(MazeLayers *layers)
+{
+    if (!layers)
+        return;
 
-    // Allouer une nouvelle chaîne de longueur -2 (+1 pour '\0')
-    char *nouvelle_chaine = (char *)malloc((longueur - 1) * sizeof(char));
-    if (!nouvelle_chaine)
+    for (int c = 0; c < CHUNK_CACHE_SIZE; c++)
     {
-        return NULL; // Retourner NULL en cas d'échec d'allocation
+        if (layers->chunks[c].tiles)
+            SDL_DestroyTexture(layers->chunks[c].tiles);
+        if (layers->chunks[c].visited)
+            SDL_DestroyTexture(layers->chunks[c].visited);
     }
-
-    strncpy(nouvelle_chaine, source + 1, longueur - 2);
-    nouvelle_chaine[longueur - 2] = '\0'; // Assurer la terminaison
-
-    return nouvelle_chaine;
+    free_board_batch(&layers->batch);
+    free(layers);
 }
 
-// Shortest path function that returns the path as a string
-char *find_shortest_path(Graph *graph, Node *start, Node *end, int GRID_SIZE)
+// Layers of a graph of GRID_SIZE, or of an endless maze when stream is not NULL (graph is then NULL)
+MazeLayers *create_maze_layers(SDL_Renderer *renderer, Graph *graph, MazeStream *stream, GlyphAtlas *atlas, int GRID_SIZE)
 {
-    int distances[MAX_POINTS];
-    Node *previous[MAX_POINTS];
-
-    // printf("Graph node count: %d\n", graph->node_count);
-
-    // Initialize distances and previous nodes
-    for (int i = 0; i < graph->node_count; i++)
-    {
-        distances[i] = INF;
-        previous[i] = NULL;
-    }
-
-    // printf("Start Node: (%d, %d) with letter '%c'\n", start->x, start->y, start->letter);
-    // printf("End Node: (%d, %d) with letter '%c'\n", end->x, end->y, end->letter);
-
-    distances[start->x * GRID_SIZE + start->y] = 0;
-
-    PriorityQueue pq = {.size = 0};
-    push(&pq, start, 0);
-
-    while (pq.size > 0)
-    {
-        Node *current = pop(&pq);
-        if (current == end)
-            break;
-
-        int currentIndex = current->x * GRID_SIZE + current->y;
-        // printf("Processing Node: (%d, %d) with letter '%c'\n", current->x, current->y, current->letter);
-        // printf("Neighbors Count: %d\n", current->neighbor_count);
-
-        for (int i = 0; i < current->neighbor_count; i++)
-        {
-            Node *neighbor = current->neighbors[i];
-
-            // Skip walls
-            if (neighbor->letter == '#')
-            {
-                // printf("Skipping wall at (%d, %d)\n", neighbor->x, neighbor->y);
-                continue;
-            }
-
-            int neighborIndex = neighbor->x * GRID_SIZE + neighbor->y;
-            int alt = distances[currentIndex] + 1;
-
-            // printf("Evaluating Neighbor: (%d, %d) with letter '%c'\n", neighbor->x, neighbor->y, neighbor->letter);
-            // printf("Current Distance: %d, New Distance: %d\n", distances[neighborIndex], alt);
-
-            if (alt < distances[neighborIndex])
-            {
-                distances[neighborIndex] = alt;
-                previous[neighborIndex] = current;
-                push(&pq, neighbor, alt);
-                // printf("Updating path: Previous[%d] = (%d, %d)\n", neighborIndex, current->x, current->y);
-            }
-        }
-    }
-
-    // If no path was found
-    if (previous[end->x * GRID_SIZE + end->y] == NULL)
-    {
-        // printf("No path found between (%d, %d) and (%d, %d).\n", start->x, start->y, end->x, end->y);
-        return NULL;
-    }
-
-    // Reconstruct the path and collect letters
-    Node *path[MAX_POINTS];
-    int path_length = 0;
-
-    for (Node *at = end; at != NULL; at = previous[at->x * GRID_SIZE + at->y])
-    {
-        path[path_length++] = at;
-        // printf("Adding to path: (%d, %d) with letter '%c'\n", at->x, at->y, at->letter);
-    }
-
-    // Create a string from collected letters
-    char *word = malloc(path_length + 1);
-    if (!word)
+    MazeLayers *layers = (MazeLayers *)calloc(1, sizeof(MazeLayers));
+    if (!layers)
     {
         printf("Memory allocation failed.\n");
         return NULL;
     }
 
-    printf("Final Path Collected Letters: ");
-    for (int i = 0; i < path_length; i++)
-    {
-        word[i] = path[path_length - 1 - i]->letter; // Reverse order
-        printf("%c ", word[i]);
-    }
-    word[path_length] = '\0';
-    printf("\n");
-    printf("Final Path: %s\n", word);
-    return (word);
+    layers->rows = stream ? INT_MAX : GRID_SIZE;
+    layers->cols = stream ? stream->width : GRID_SIZE;
+    layers->renderer = renderer;
+    layers->graph = graph;
+    layers->stream = stream;
+    layers->atlas = atlas;
+    invalidate_chunks(layers);
+    return layers;
 }
 
-int get_distance(Node *a, Node *b)
+// First node of a board row, NULL if an endless maze does not keep it
+Node *layer_row(MazeLayers *layers, int row)
 {
-    return abs(a->x - b->x) + abs(a->y - b->y);
+    return layers->stream ? stream_row(layers->stream, row) : &layers->graph->nodes[row * layers->cols];
 }
-// Find the optimal order to visit words (Greedy nearest neighbor)
-// Find the optimal order to visit words (Greedy nearest neighbor)
-void find_best_word_order(Graph *graph, WordPosition *word_positions, int word_count, Node **visit_order, int GRID_SIZE)
-{
-    int visited[word_count];
-    memset(visited, 0, sizeof(visited));
 
-    Node *current = graph->start;
-    int order_index = 0;
-
-    for (int i = 0; i < word_count; i++)
+// Draw a chunk into its textures
+void build_chunk(MazeLayers *layers, Chunk *chunk)
+{
+    int first_row = chunk->row * CHUNK_CELLS, first_col = chunk->col * CHUNK_CELLS;
+    int rows = SDL_min(CHUNK_CELLS, layers->rows - first_row), cols = SDL_min(CHUNK_CELLS, layers->cols - first_col);
+    Node *row_nodes[CHUNK_CELLS];
+    for (int i = 0; i < rows; i++)
+        row_nodes[i] = layer_row(layers, first_row + i);
+
+    SDL_SetRenderTarget(layers->renderer, chunk->tiles);
+    SDL_SetRenderDrawColor(layers->renderer, 255, 255, 255, 255);
+    SDL_RenderClear(layers->renderer);
+    draw_static_layer(layers->renderer, row_nodes, layers->atlas, &layers->batch, first_col, rows, cols);
+    SDL_SetRenderTarget(layers->renderer, NULL);
+
+    Uint8 pixels[CHUNK_CELLS * CHUNK_CELLS * 4] = {0};
+    for (int i = 0; i < rows; i++)
     {
-        int best_index = -1;
-        int min_distance = INT_MAX;
-
-        for (int j = 0; j < word_count; j++)
+        for (int j = 0; row_nodes[i] && j < cols; j++)
         {
-            if (!visited[j])
-            {
-                Node *word_start = graph->nodes[word_positions[j].startX * GRID_SIZE + word_positions[j].startY];
-                int distance = get_distance(current, word_start);
-
-                if (distance < min_distance)
-                {
-                    min_distance = distance;
-                    best_index = j;
-                }
-            }
-        }
-
-        if (best_index != -1)
-        {
-            visited[best_index] = 1;
-
-            // Visit word start position
-            visit_order[order_index++] = graph->nodes[word_positions[best_index].startX * GRID_SIZE + word_positions[best_index].startY];
-
-            // Visit word end position
-            visit_order[order_index++] = graph->nodes[word_positions[best_index].endX * GRID_SIZE + word_positions[best_index].endY];
-
-            // Update current position
-            current = visit_order[order_index - 1];
+            Node *node = &row_nodes[i][first_col + j];
+            if (node->visited && node->letter != '#')
+                memcpy(pixels + 4 * (i * CHUNK_CELLS + j), VISITED_PIXEL, 4);
         }
     }
-
-    // Add the end node at the end of the visit order
-    visit_order[order_index] = graph->end;
+    SDL_UpdateTexture(chunk->visited, NULL, pixels, CHUNK_CELLS * 4);
 }
 
-// Function to compute and print the full path (start → word start → word end → next word → end)
-char *concatenate_paths(char **segments, int count)
+// Chunk at (row, col), built if it is not in the cache. NULL if its textures cannot be created.
+Chunk *get_chunk(MazeLayers *layers, int row, int col)
 {
-    int total_length = 0;
-
-    // Calculate total length needed
-    for (int i = 0; i < count; i++)
+    Chunk *slot = &layers->chunks[0];
+    layers->uses++;
+    for (int c = 0; c < CHUNK_CACHE_SIZE; c++)
     {
-        if (segments[i])
+        Chunk *chunk = &layers->chunks[c];
+        if (chunk->row == row && chunk->col == col)
         {
-            total_length += strlen(segments[i]);
+            chunk->last_used = layers->uses;
+            return chunk;
         }
+        if (chunk->last_used < slot->last_used)
+            slot = chunk;
     }
 
-    // Allocate memory for final path
-    char *final_path = malloc(total_length + 1);
-    if (!final_path)
-        return NULL;
-
-    final_path[0] = '\0'; // Initialize as empty string
-
-    // Concatenate all segments
-    for (int i = 0; i < count; i++)
+    // Textures are created once per slot and reused by the chunks that come after
+    if (!slot->tiles)
     {
-        if (segments[i])
+        slot->tiles = SDL_CreateTexture(layers->renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_TARGET,
+                                        CHUNK_CELLS * CELL_SIZE, CHUNK_CELLS * CELL_SIZE);
+        slot->visited = SDL_CreateTexture(layers->renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STREAMING, CHUNK_CELLS, CHUNK_CELLS);
+        if (!slot->tiles || !slot->visited)
         {
-            strcat(final_path, segments[i]);
+            printf("Erreur : impossible de créer les textures du labyrinthe : %s\n", SDL_GetError());
+            if (slot->tiles)
+                SDL_DestroyTexture(slot->tiles);
+            if (slot->visited)
+                SDL_DestroyTexture(slot->visited);
+            slot->tiles = NULL;
+            slot->visited = NULL;
+            return NULL;
         }
+        SDL_SetTextureBlendMode(slot->visited, SDL_BLENDMODE_BLEND);
+        SDL_SetTextureScaleMode(slot->visited, SDL_ScaleModeNearest); // Sharp cell edges when stretched
+        textures_created += 2;
     }
 
-    return final_path;
+    slot->row = row;
+    slot->col = col;
+    slot->last_used = layers->uses;
+    build_chunk(layers, slot);
+    return slot;
 }
 
-char *find_best_path(Graph *graph, WordPosition *word_positions, int word_count, int GRID_SIZE)
+// Update the visited overlay for one cell, after a move (chunks out of the cache are built from
+// the nodes when they come back)
+void mark_visited_cell(MazeLayers *layers, Node *node)
 {
-    Node **visit_order = malloc((word_count * 2 + 2) * sizeof(Node *));
-    if (!visit_order)
-    {
-        printf("Memory allocation failed!\n");
-        return NULL;
-    }
-
-    visit_order[0] = graph->start;
-
-    // Compute the best order to visit words
-    find_best_word_order(graph, word_positions, word_count, &visit_order[1], GRID_SIZE);
-
-    // Array to store path segments
-    char **path_segments = malloc((word_count * 2 + 1) * sizeof(char *));
-    if (!path_segments)
+    for (int c = 0; c < CHUNK_CACHE_SIZE; c++)
     {
-        printf("Memory allocation failed!\n");
-        free(visit_order);
-        return NULL;
-    }
-
-    printf("\nOptimal Path:\n");
-    for (int i = 0; i < word_count * 2 + 1; i++)
-    {
-        path_segments[i] = find_shortest_path(graph, visit_order[i], visit_order[i + 1], GRID_SIZE);
-
-        // Remove redundant start & end nodes from paths
-        if (i > 0)
+        Chunk *chunk = &layers->chunks[c];
+        if (chunk->row == node->x / CHUNK_CELLS && chunk->col == node->y / CHUNK_CELLS)
         {
-            char *prev_path = path_segments[i - 1];
-            char *curr_path = path_segments[i];
-
-            // Ensure we don’t repeat the last character of prev_path and first of curr_path
-            if (prev_path && curr_path)
-            {
-                int prev_len = strlen(prev_path);
-                int curr_len = strlen(curr_path);
-
-                // If last char of prev_path matches first char of curr_path, remove duplicate
-                if (prev_len > 0 && curr_len > 0 && prev_path[prev_len - 1] == curr_path[0])
-                {
-                    memmove(curr_path, curr_path + 1, curr_len); // Shift left to remove duplicate
-                }
-            }
+            SDL_Rect pixel = {node->y % CHUNK_CELLS, node->x % CHUNK_CELLS, 1, 1};
+            SDL_UpdateTexture(chunk->visited, &pixel, node->visited ? VISITED_PIXEL : UNVISITED_PIXEL, 4);
+            return;
         }
     }
-
-    // Concatenate all path segments into a single path
-    char *final_path = concatenate_paths(path_segments, word_count * 2 + 1);
-    if (final_path)
-    {
-        printf("%s\n", final_path);
-    }
-
-    // Free allocated memory
-    for (int i = 0; i < word_count * 2 + 1; i++)
-    {
-        free(path_segments[i]);
-    }
-    free(path_segments);
-    free(visit_order);
-    return final_path;
 }
 
-void draw_graph(SDL_Renderer *renderer, Graph *graph, Player *player, TTF_Font *font, int GRID_SIZE)
+// Draw the chunks the camera sees
+void draw_chunks(SDL_Renderer *renderer, MazeLayers *layers, Camera *camera)
 {
-    // Draw all the cells in the grid
-    for (int i = 0; i < GRID_SIZE; i++)
+    int chunk_size = CHUNK_CELLS * CELL_SIZE;
+    int row_chunks = layers->rows / CHUNK_CELLS + (layers->rows % CHUNK_CELLS != 0);
+    int col_chunks = layers->cols / CHUNK_CELLS + (layers->cols % CHUNK_CELLS != 0);
+    int first_col = SDL_max(0, (int)SDL_floorf(camera->x / chunk_size));
+    int first_row = SDL_max(0, (int)SDL_floorf(camera->y / chunk_size));
+    int last_col = SDL_min(col_chunks - 1, (int)SDL_floorf((camera->x + camera->width / camera->zoom) / chunk_size));
+    int last_row = SDL_min(row_chunks - 1, (int)SDL_floorf((camera->y + camera->height / camera->zoom) / chunk_size));
+
+    for (int row = first_row; row <= last_row; row++)
     {
-        for (int j = 0; j < GRID_SIZE; j++)
+        for (int col = first_col; col <= last_col; col++)
         {
-            Node *node = graph->nodes[i * GRID_SIZE + j];
-            SDL_Rect cell = {j * CELL_SIZE, i * CELL_SIZE, CELL_SIZE, CELL_SIZE};
-
-            // Draw walls (dark gray)
-            if (node->letter == '#')
-            {
-                SDL_SetRenderDrawColor(renderer, 50, 50, 50, 255);
-                SDL_RenderFillRect(renderer, &cell);
-            }
-            else
-            {
-                // Draw empty cells (light gray)
-                SDL_SetRenderDrawColor(renderer, 220, 220, 220, 255);
-                SDL_RenderFillRect(renderer, &cell);
-
-                // Draw the letters in the cells (if any)
-                if (node->letter != ' ')
-                {
-                    char letter[2] = {node->letter, '\0'};
-                    SDL_Color textColor = {0, 0, 0, 255}; // Black for letters
-                    SDL_Surface *textSurface = TTF_RenderText_Blended(font, letter, textColor);
-                    SDL_Texture *textTexture = SDL_CreateTextureFromSurface(renderer, textSurface);
-                    int textW, textH;
-                    SDL_QueryTexture(textTexture, NULL, NULL, &textW, &textH);
-                    SDL_Rect textRect = {cell.x + (CELL_SIZE - textW) / 2, cell.y + (CELL_SIZE - textH) / 2, textW, textH};
-                    SDL_RenderCopy(renderer, textTexture, NULL, &textRect);
-                    SDL_DestroyTexture(textTexture);
-                    SDL_FreeSurface(textSurface);
-                }
-                // Highlight visited cells with orange transparency
-                if (node->visited)
-                {
-                    SDL_SetRenderDrawColor(renderer, 255, 165, 0, 100); // Orange with transparency
-                    SDL_RenderFillRect(renderer, &cell);
-                }
-            }
+            Chunk *chunk = get_chunk(layers, row, col);
+            if (!chunk)
+                continue;
 
-            // Draw grid lines (light gray)
-            SDL_SetRenderDrawColor(renderer, 200, 200, 200, 255);
-            SDL_RenderDrawRect(renderer, &cell);
+            // Only the part of the chunk inside the board
+            int cells_down = SDL_min(CHUNK_CELLS, layers->rows - row * CHUNK_CELLS);
+            int cells_across = SDL_min(CHUNK_CELLS, layers->cols - col * CHUNK_CELLS);
+            SDL_Rect tiles = {0, 0, cells_across * CELL_SIZE, cells_down * CELL_SIZE};
+            SDL_Rect cells = {0, 0, cells_across, cells_down};
+            SDL_Rect target = camera_rect(camera, col * chunk_size, row * chunk_size, tiles.w, tiles.h);
+            SDL_RenderCopy(renderer, chunk->tiles, &tiles, &target);
+            SDL_RenderCopy(renderer, chunk->visited, &cells, &target);
         }
     }
+}
 
+// Draw the player's cell, returns where it is in the window
+SDL_Rect draw_player(SDL_Renderer *renderer, Player *player, Camera *camera)
+{
     // Set transparency for the player
     SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
 
     // Draw the player's character inside the active cell last
-    SDL_Rect playerRect = {player->y * CELL_SIZE, player->x * CELL_SIZE, CELL_SIZE, CELL_SIZE};
+    SDL_Rect playerRect = camera_rect(camera, player->y * CELL_SIZE, player->x * CELL_SIZE, CELL_SIZE, CELL_SIZE);
 
     // Draw the player's active cell border (blue)
     SDL_SetRenderDrawColor(renderer, 0, 0, 255, 255); // Blue color for the player's cell border
@@ -895,23 +475,147 @@ void draw_graph(SDL_Renderer *renderer, Graph *graph, Player *player, TTF_Font *
     // Draw the player's character (blue rectangle) with transparency
     SDL_SetRenderDrawColor(renderer, 0, 0, 255, 100); // Semi-transparent blue
     SDL_RenderFillRect(renderer, &playerRect);        // Fill the cell where the player is
+    return playerRect;
+}
+
+// Draw the part of the maze the camera sees; hints may be NULL (no hint arrow)
+void draw_graph(SDL_Renderer *renderer, Graph *graph, Player *player, MazeLayers *layers, Camera *camera, HintFields *hints, int GRID_SIZE)
+{
+    draw_chunks(renderer, layers, camera);
+    SDL_Rect playerRect = draw_player(renderer, player, camera);
 
     // Draw the start point (green with border)
     SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255); // Green color
-    SDL_Rect startRect = {graph->start->y * CELL_SIZE, graph->start->x * CELL_SIZE, CELL_SIZE, CELL_SIZE};
+    SDL_Rect startRect = camera_rect(camera, graph->start->y * CELL_SIZE, graph->start->x * CELL_SIZE, CELL_SIZE, CELL_SIZE);
     SDL_RenderFillRect(renderer, &startRect);         // Fill start point cell
     SDL_SetRenderDrawColor(renderer, 0, 200, 0, 255); // Darker green for border
     SDL_RenderDrawRect(renderer, &startRect);
 
     // Draw the end point (red with border)
     SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255); // Red color
-    SDL_Rect endRect = {graph->end->y * CELL_SIZE, graph->end->x * CELL_SIZE, CELL_SIZE, CELL_SIZE};
+    SDL_Rect endRect = camera_rect(camera, graph->end->y * CELL_SIZE, graph->end->x * CELL_SIZE, CELL_SIZE, CELL_SIZE);
     SDL_RenderFillRect(renderer, &endRect);           // Fill end point cell
     SDL_SetRenderDrawColor(renderer, 200, 0, 0, 255); // Darker red for border
     SDL_RenderDrawRect(renderer, &endRect);
+
+    // Hint arrow from the player's cell towards the suggested next cell (purple)
+    int hint = hints ? hint_direction(hints, graph, player, GRID_SIZE) : -1;
+    if (hint >= 0)
+    {
+        int ux = DIR_DY[hint], uy = DIR_DX[hint]; // Screen x follows the grid column
+        int cell = playerRect.w;
+        int fromX = playerRect.x + cell / 2, fromY = playerRect.y + cell / 2;
+        int tipX = fromX + ux * cell * 3 / 4, tipY = fromY + uy * cell * 3 / 4;
+        int head = cell / 4;
+
+        SDL_SetRenderDrawColor(renderer, 160, 0, 200, 255);
+        SDL_RenderDrawLine(renderer, fromX, fromY, tipX, tipY);
+        SDL_RenderDrawLine(renderer, tipX, tipY, tipX - (ux + uy) * head, tipY - (uy - ux) * head);
+        SDL_RenderDrawLine(renderer, tipX, tipY, tipX - (ux - uy) * head, tipY - (uy + ux) * head);
+    }
+}
+
+// Text rendered once and kept as textures, keyed by string, font style and color, for the menus
+// and any HUD text. Each highlight state is its own entry, so moving the selection only switches
+// entries. When the cache is full the least recently used entry is replaced.
+#define TEXT_CACHE_SIZE 32
+#define TEXT_CACHE_LENGTH 64 // Longest cached string, longer ones are cut
+
+typedef struct
+{
+    char text[TEXT_CACHE_LENGTH];
+    int style; // TTF_STYLE_*
+    SDL_Color color;
+    SDL_Texture *texture; // NULL for a free entry
+    unsigned long last_used;
+} TextEntry;
+
+typedef struct
+{
+    SDL_Renderer *renderer;
+    TTF_Font *font;
+    TextEntry entries[TEXT_CACHE_SIZE];
+    unsigned long uses;
+} TextCache;
+
+TextCache *create_text_cache(SDL_Renderer *renderer, TTF_Font *font)
+{
+    TextCache *cache = (TextCache *)calloc(1, sizeof(TextCache));
+    if (!cache)
+    {
+        printf("Memory allocation failed.\n");
+        return NULL;
+    }
+    cache->renderer = renderer;
+    cache->font = font;
+    return cache;
+}
+
+void free_text_cache(TextCache *cache)
+{
+    if (!cache)
+        return;
+
+    for (int i = 0; i < TEXT_CACHE_SIZE; i++)
+    {
+        if (cache->entries[i].texture)
+            SDL_DestroyTexture(cache->entries[i].texture);
+    }
+    free(cache);
+}
+
+// Texture of a text, rendered with TTF_RenderText_Solid the first time it is asked for
+SDL_Texture *get_text_texture(TextCache *cache, const char *text, int style, SDL_Color color)
+{
+    TextEntry *slot = &cache->entries[0];
+    cache->uses++;
+    for (int i = 0; i < TEXT_CACHE_SIZE; i++)
+    {
+        TextEntry *entry = &cache->entries[i];
+        if (entry->texture && entry->style == style && strncmp(entry->text, text, TEXT_CACHE_LENGTH - 1) == 0 &&
+            entry->color.r == color.r && entry->color.g == color.g && entry->color.b == color.b && entry->color.a == color.a)
+        {
+            entry->last_used = cache->uses;
+            return entry->texture;
+        }
+
+        // Keep a free entry, or else the least recently used one
+        if (slot->texture && (!entry->texture || entry->last_used < slot->last_used))
+            slot = entry;
+    }
+
+    int previous_style = TTF_GetFontStyle(cache->font);
+    TTF_SetFontStyle(cache->font, style);
+    SDL_Surface *surface = TTF_RenderText_Solid(cache->font, text, color);
+    TTF_SetFontStyle(cache->font, previous_style);
+    if (!surface)
+        return NULL;
+
+    SDL_Texture *texture = SDL_CreateTextureFromSurface(cache->renderer, surface);
+    SDL_FreeSurface(surface);
+    if (!texture)
+        return NULL;
+    textures_created++;
+
+    if (slot->texture)
+        SDL_DestroyTexture(slot->texture);
+    snprintf(slot->text, TEXT_CACHE_LENGTH, "%s", text);
+    slot->style = style;
+    slot->color = color;
+    slot->texture = texture;
+    slot->last_used = cache->uses;
+    return texture;
 }
 
-int show_difficulty_selection(SDL_Renderer *renderer, TTF_Font *font, int WINDOW_SIZE)
+// Draw a cached text stretched into rect
+void draw_text(TextCache *cache, const char *text, int style, SDL_Color color, SDL_Rect *rect)
+{
+    SDL_Texture *texture = get_text_texture(cache, text, style, color);
+    if (texture)
+        SDL_RenderCopy(cache->renderer, texture, NULL, rect);
+}
+
+int show_difficulty_selection(SDL_Renderer *renderer, TextCache *texts, int WINDOW_SIZE)
 {
     SDL_Event event;
     int running = 1;
@@ -919,11 +623,14 @@ int show_difficulty_selection(SDL_Renderer *renderer, TTF_Font *font, int WINDOW
     SDL_Color white = {255, 255, 255, 255};
     SDL_Color blue = {0, 0, 255, 255}; // Blue for selected text
 
+    bool redraw = true;
+
     while (running)
     {
-        while (SDL_PollEvent(&event))
+        // Sleep until something happens
+        if (!redraw)
         {
-            if (event.type == SDL_QUIT)
+            if (!SDL_WaitEvent(&event) || event.type == SDL_QUIT)
             {
                 return 1;
             }
@@ -941,82 +648,48 @@ int show_difficulty_selection(SDL_Renderer *renderer, TTF_Font *font, int WINDOW
                 {
                     return selected; // Return the selected difficulty
                 }
+                redraw = true;
+            }
+            else if (event.type == SDL_WINDOWEVENT || event.type == SDL_RENDER_TARGETS_RESET)
+            {
+                redraw = true;
             }
+            continue;
         }
+        redraw = false;
 
         // Set background to white
         SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255); // Black background
         SDL_RenderClear(renderer);
 
-        // Render difficulty options
-        SDL_Surface *easySurface = TTF_RenderText_Solid(font, "Easy", selected == 0 ? blue : white);
-        SDL_Surface *mediumSurface = TTF_RenderText_Solid(font, "Medium", selected == 1 ? blue : white);
-        SDL_Surface *hardSurface = TTF_RenderText_Solid(font, "Hard", selected == 2 ? blue : white);
-
-        SDL_Texture *easyTexture = SDL_CreateTextureFromSurface(renderer, easySurface);
-        SDL_Texture *mediumTexture = SDL_CreateTextureFromSurface(renderer, mediumSurface);
-        SDL_Texture *hardTexture = SDL_CreateTextureFromSurface(renderer, hardSurface);
-
         // Render difficulty options, centered horizontally
         SDL_Rect easyRect = {50, WINDOW_SIZE / 2 - 30, 60, 40};   // Easy option
         SDL_Rect mediumRect = {50, WINDOW_SIZE / 2 + 20, 80, 40}; // Medium option
         SDL_Rect hardRect = {50, WINDOW_SIZE / 2 + 70, 60, 40};   // Hard option
 
-        SDL_RenderCopy(renderer, easyTexture, NULL, &easyRect);
-        SDL_RenderCopy(renderer, mediumTexture, NULL, &mediumRect);
-        SDL_RenderCopy(renderer, hardTexture, NULL, &hardRect);
-
-        SDL_FreeSurface(easySurface);
-        SDL_FreeSurface(mediumSurface);
-        SDL_FreeSurface(hardSurface);
-        SDL_DestroyTexture(easyTexture);
-        SDL_DestroyTexture(mediumTexture);
-        SDL_DestroyTexture(hardTexture);
+        draw_text(texts, "Easy", TTF_STYLE_BOLD, selected == 0 ? blue : white, &easyRect);
+        draw_text(texts, "Medium", TTF_STYLE_BOLD, selected == 1 ? blue : white, &mediumRect);
+        draw_text(texts, "Hard", TTF_STYLE_BOLD, selected == 2 ? blue : white, &hardRect);
 
         SDL_RenderPresent(renderer);
     }
     return 1;
 }
 
-// calucl score
-int calculate_score(char *path, WordPosition *word_positions, int word_count, int best_path_length)
-{
-    int score = 0;
-    int all_words_found = 1; // Assume all words are found
-    for (int i = 0; i < word_count; i++)
-    {
-        const char *word = word_positions[i].word;
-        char *found = strstr(path, word);
-        if (found)
-        {
-            score += strlen(word) * 3;
-        }
-        else
-        {
-            all_words_found = 0; // If any word is not found, set this to 0
-        }
-    }
-
-    // If all words are found and the path length is the best path length, add 50 bonus points
-    if (all_words_found && strlen(path) <= best_path_length)
-    {
-        score += 50;
-    }
-
-    return score;
-}
-
-int show_menu(SDL_Renderer *renderer, TTF_Font *font, int WINDOW_SIZE)
+int show_menu(SDL_Renderer *renderer, TextCache *texts, int WINDOW_SIZE)
 {
     SDL_Event event;
     int running = 1;
     int selected = 0; // 0: New Game, 1: Quit
 
+    bool redraw = true;
+
     while (running)
     {
-        while (SDL_PollEvent(&event))
+        // Sleep until something happens
+        if (!redraw)
         {
-            if (event.type == SDL_QUIT)
+            if (!SDL_WaitEvent(&event) || event.type == SDL_QUIT)
             {
                 return 1;
             }
@@ -1031,7 +704,7 @@ int show_menu(SDL_Renderer *renderer, TTF_Font *font, int WINDOW_SIZE)
                     if (selected == 0)
                     {
                         // New game selected, show difficulty selection
-                        int difficulty = show_difficulty_selection(renderer, font, WINDOW_SIZE);
+                        int difficulty = show_difficulty_selection(renderer, texts, WINDOW_SIZE);
                         return difficulty;
                     }
                     else
@@ -1039,8 +712,15 @@ int show_menu(SDL_Renderer *renderer, TTF_Font *font, int WINDOW_SIZE)
                         return -1; // Quit game
                     }
                 }
+                redraw = true;
             }
+            else if (event.type == SDL_WINDOWEVENT || event.type == SDL_RENDER_TARGETS_RESET)
+            {
+                redraw = true;
+            }
+            continue;
         }
+        redraw = false;
 
         // Set background to white
         SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255); // White background
@@ -1050,55 +730,279 @@ int show_menu(SDL_Renderer *renderer, TTF_Font *font, int WINDOW_SIZE)
         SDL_Color blue = {0, 0, 255, 255};      // Blue for selected text
 
         // Render header
-        SDL_Surface *headerSurface = TTF_RenderText_Solid(font, "Welcome to The Maze Game", white);
-        SDL_Texture *headerTexture = SDL_CreateTextureFromSurface(renderer, headerSurface);
         SDL_Rect headerRect = {50, 50, 300, 40};
-        SDL_RenderCopy(renderer, headerTexture, NULL, &headerRect);
-        SDL_FreeSurface(headerSurface);
-        SDL_DestroyTexture(headerTexture);
+        draw_text(texts, "Welcome to The Maze Game", TTF_STYLE_NORMAL, white, &headerRect);
 
-        TTF_SetFontStyle(font, TTF_STYLE_BOLD);
         // Render "New Game" and "Quit Game" with different colors based on selection
-        SDL_Surface *newGameSurface = TTF_RenderText_Solid(font, "New Game", selected == 0 ? blue : white);
-        SDL_Surface *quitSurface = TTF_RenderText_Solid(font, "Quit Game", selected == 1 ? blue : white);
-
-        SDL_Texture *newGameTexture = SDL_CreateTextureFromSurface(renderer, newGameSurface);
-        SDL_Texture *quitTexture = SDL_CreateTextureFromSurface(renderer, quitSurface);
-
         SDL_Rect newGameRect = {50, WINDOW_SIZE / 2 - 20, 100, 40};
         SDL_Rect quitRect = {50, WINDOW_SIZE / 2 + 20, 100, 40};
-
-        SDL_RenderCopy(renderer, newGameTexture, NULL, &newGameRect);
-        SDL_RenderCopy(renderer, quitTexture, NULL, &quitRect);
-
-        SDL_FreeSurface(newGameSurface);
-        SDL_FreeSurface(quitSurface);
-        SDL_DestroyTexture(newGameTexture);
-        SDL_DestroyTexture(quitTexture);
+        draw_text(texts, "New Game", TTF_STYLE_BOLD, selected == 0 ? blue : white, &newGameRect);
+        draw_text(texts, "Quit Game", TTF_STYLE_BOLD, selected == 1 ? blue : white, &quitRect);
 
         // Render footer
-        SDL_Surface *footerSurface = TTF_RenderText_Solid(font, "Made by Caption", white);
-        SDL_Texture *footerTexture = SDL_CreateTextureFromSurface(renderer, footerSurface);
         SDL_Rect footerRect = {300, WINDOW_SIZE - 50, 200, 30};
-        SDL_RenderCopy(renderer, footerTexture, NULL, &footerRect);
-        SDL_FreeSurface(footerSurface);
-        SDL_DestroyTexture(footerTexture);
+        draw_text(texts, "Made by Caption", TTF_STYLE_BOLD, white, &footerRect);
 
         SDL_RenderPresent(renderer);
     }
     return 1;
 }
 
+// Loop statistics (--frame-stats) are printed every FRAME_STATS_INTERVAL milliseconds
+#define FRAME_STATS_INTERVAL 1000
+
+// Longest sleep of the game loop when nothing happens, so the statistics still come out
+#define IDLE_WAIT_MS 1000
+
+// Largest board that gets the hint arrow (its distance fields take one int per cell and per word).
+// --size goes up to MAX_GRID_SIZE, the largest board of a maze file.
+#define MAX_HINT_CELLS (1 << 20)
+
+// Seeds tried in a row for a maze with a start and an end (half of the 5x5 mazes have none)
+#define MAX_MAZE_ATTEMPTS 100
 
+// Zoom step of the keypad +/- keys and of the mouse wheel
+#define ZOOM_STEP 1.25f
+
+// Where F5 saves the game, to be played again with --load=
+#define SAVE_FILE "partie.maze"
+
+// Numeric keypad directions
+static const struct
+{
+    SDL_Scancode key;
+    int dx, dy;
+} MOVE_KEYS[] = {
+    {SDL_SCANCODE_KP_8, -1, 0},
+    {SDL_SCANCODE_KP_2, 1, 0},
+    {SDL_SCANCODE_KP_4, 0, -1},
+    {SDL_SCANCODE_KP_6, 0, 1},
+    {SDL_SCANCODE_KP_7, -1, -1},
+    {SDL_SCANCODE_KP_9, -1, 1},
+    {SDL_SCANCODE_KP_1, 1, -1},
+    {SDL_SCANCODE_KP_3, 1, 1},
+};
+#define MOVE_KEY_COUNT (int)(sizeof(MOVE_KEYS) / sizeof(MOVE_KEYS[0]))
+
+// Survival mode (--survival): an endless maze made row by row below the player (see maze_stream.h),
+// whose top falls away one row every SURVIVAL_COLLAPSE_MS. The game ends when the fall reaches the
+// player, the score is the deepest row reached plus the points of the words spelled on the way.
+// Memory stays the same however deep the player goes: the maze keeps SURVIVAL_ROWS rows, and the
+// chunks of the board are a fixed cache.
+#define SURVIVAL_WIDTH 31        // Columns, unless --size is given
+#define SURVIVAL_ROWS 512        // Rows kept
+#define SURVIVAL_AHEAD 128       // Rows made below the player, more than a window shows at the smallest zoom
+#define SURVIVAL_COLLAPSE_MS 1000
+
+// Play the survival mode in the window, returns the score
+int play_survival(SDL_Window *window, SDL_Renderer *renderer, GlyphAtlas *atlas, int width, unsigned long long seed)
+{
+    static char words[1000][20];
+    const char *word_ptrs[1000];
+    int word_total = load_words("dictionnaire.txt", words, 1000);
+    for (int i = 0; i < word_total; i++)
+        word_ptrs[i] = words[i];
+
+    MazeStream *stream = create_maze_stream(width, SURVIVAL_ROWS, word_ptrs, word_total, seed);
+    if (!stream)
+        return 0;
+    Player player;
+    initialize_stream_player(&player, stream);
+    fill_stream(stream, player.x + SURVIVAL_AHEAD);
+
+    MazeLayers *layers = create_maze_layers(renderer, NULL, stream, atlas, width);
+    if (!layers)
+    {
+        free_maze_stream(stream);
+        return 0;
+    }
+
+    int window_width = SDL_min(width * CELL_SIZE, 800), window_height = 800;
+    SDL_SetWindowSize(window, window_width, window_height);
+    Camera camera = {0, 0, 1.0f, window_width, window_height};
+    zoom_camera(&camera, 1.0f);
+    printf("Survival: go down before the maze falls away (one row every %d ms).\n", SURVIVAL_COLLAPSE_MS);
+
+    int fallen = 0; // Rows above this one are gone
+    int deepest = 0;
+    Uint32 fall_time = SDL_GetTicks(), lastMoveTime = 0, moveDelay = 150;
+    bool redraw = true;
+    SDL_Event event;
+    while (player.x >= fallen)
+    {
+        // Sleep until an event, the next move while a move key is held, or the next row falling
+        const Uint8 *keystate = SDL_GetKeyboardState(NULL);
+        bool move_key_held = false;
+        for (int k = 0; k < MOVE_KEY_COUNT; k++)
+            move_key_held = move_key_held || keystate[MOVE_KEYS[k].key];
+
+        Uint32 now = SDL_GetTicks();
+        int timeout = now - fall_time >= SURVIVAL_COLLAPSE_MS ? 0 : (int)(SURVIVAL_COLLAPSE_MS - (now - fall_time));
+        if (move_key_held)
+        {
+            Uint32 since_move = now - lastMoveTime;
+            timeout = SDL_min(timeout, since_move > moveDelay ? 0 : (int)(moveDelay - since_move) + 1);
+        }
+
+        bool quit = false;
+        int has_event = SDL_WaitEventTimeout(&event, timeout);
+        while (has_event)
+        {
+            if (event.type == SDL_QUIT)
+            {
+                quit = true;
+            }
+            else if (event.type == SDL_KEYDOWN && (event.key.keysym.scancode == SDL_SCANCODE_KP_PLUS || event.key.keysym.scancode == SDL_SCANCODE_KP_MINUS))
+            {
+                zoom_camera(&camera, event.key.keysym.scancode == SDL_SCANCODE_KP_PLUS ? ZOOM_STEP : 1 / ZOOM_STEP);
+                redraw = true;
+            }
+            else if (event.type == SDL_MOUSEWHEEL && event.wheel.y != 0)
+            {
+                zoom_camera(&camera, event.wheel.y > 0 ? ZOOM_STEP : 1 / ZOOM_STEP);
+                redraw = true;
+            }
+            else if (event.type == SDL_RENDER_TARGETS_RESET)
+            {
+                invalidate_chunks(layers);
+                redraw = true;
+            }
+            else if (event.type == SDL_WINDOWEVENT)
+            {
+                if (event.window.event == SDL_WINDOWEVENT_RESIZED)
+                {
+                    camera.width = event.window.data1;
+                    camera.height = event.window.data2;
+                    zoom_camera(&camera, 1.0f);
+                }
+                redraw = true;
+            }
+            has_event = SDL_PollEvent(&event);
+        }
+        if (quit)
+            break;
+
+        Uint32 currentTime = SDL_GetTicks();
+        if (currentTime - lastMoveTime > moveDelay)
+        {
+            for (int k = 0; k < MOVE_KEY_COUNT; k++)
+            {
+                if (!keystate[MOVE_KEYS[k].key])
+                    continue;
+
+                move_stream_player(&player, stream, MOVE_KEYS[k].dx, MOVE_KEYS[k].dy);
+                mark_visited_cell(layers, stream_cell(stream, player.x, player.y));
+                WordPosition *spelled = spell_stream_word(stream, &player);
+                if (spelled)
+                    printf("Word %s: +%d (%d points)\n", spelled->word, spelled->length * 3, player.score);
+                deepest = SDL_max(deepest, player.x);
+                fill_stream(stream, player.x + SURVIVAL_AHEAD); // Rows below come before they show
+                redraw = true;
+                lastMoveTime = currentTime;
+            }
+        }
+
+        // Rows fall away with time, and with the rows the maze no longer keeps
+        while (currentTime - fall_time >= SURVIVAL_COLLAPSE_MS)
+        {
+            fallen++;
+            fall_time += SURVIVAL_COLLAPSE_MS;
+            redraw = true;
+        }
+        fallen = SDL_max(fallen, stream_first_row(stream));
+
+        if (redraw)
+        {
+            SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+            SDL_RenderClear(renderer);
+            follow_player(&camera, &player, INT_MAX, width);
+            draw_chunks(renderer, layers, &camera);
+
+            // Fallen rows (dark red)
+            SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+            SDL_SetRenderDrawColor(renderer, 120, 0, 0, 200);
+            SDL_Rect fallenRect = camera_rect(&camera, 0, 0, width * CELL_SIZE, fallen * CELL_SIZE);
+            SDL_RenderFillRect(renderer, &fallenRect);
+
+            draw_player(renderer, &player, &camera);
+            SDL_RenderPresent(renderer);
+            redraw = false;
+        }
+    }
+
+    printf("Game over: row %d reached, %d points of words\n", deepest, player.score);
+    free_maze_layers(layers);
+    free_maze_stream(stream);
+    return deepest + player.score;
+}
 
 int main(int argc, char *args[])
 {
-    srand(time(NULL));
+    bool frame_stats = false;
+    bool survival = false;
+    int size_override = 0;
+    unsigned long long seed = time(NULL);
+    const char *load_file = NULL;
+    unsigned long long level_id = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        // Frames, frame time, wake-ups and time awake of the game loop, printed while playing
+        if (strcmp(args[i], "--frame-stats") == 0)
+            frame_stats = true;
+
+        // Endless maze, falling away from the top (the width is --size, or SURVIVAL_WIDTH)
+        if (strcmp(args[i], "--survival") == 0)
+            survival = true;
+
+        // Board size overriding the difficulty, for large mazes: --size=N
+        if (strncmp(args[i], "--size=", 7) == 0)
+        {
+            size_override = atoi(args[i] + 7);
+            if (size_override < 5 || size_override > MAX_GRID_SIZE)
+            {
+                printf("Erreur : taille invalide %s (5 à %d)\n", args[i] + 7, MAX_GRID_SIZE);
+                return 1;
+            }
+        }
+
+        // Maze seed, to play the same maze again: --seed=N (printed at startup)
+        if (strncmp(args[i], "--seed=", 7) == 0)
+            seed = strtoull(args[i] + 7, NULL, 10);
+
+        // Saved game or level to play instead of a new maze: --load=FILE, and --level=ID in an archive
+        if (strncmp(args[i], "--load=", 7) == 0)
+            load_file = args[i] + 7;
+        if (strncmp(args[i], "--level=", 8) == 0)
+            level_id = strtoull(args[i] + 8, NULL, 10);
+
+        // Shortest path engine: --engine=dijkstra, bfs, astar, bitboard, jps or bidirectional
+        if (strncmp(args[i], "--engine=", 9) == 0)
+        {
+            int engine = parse_engine(args[i] + 9);
+            if (engine < 0)
+            {
+                printf("Erreur : moteur inconnu %s\n", args[i] + 9);
+                return 1;
+            }
+            solver_engine = engine;
+        }
+    }
+
+    // The level is read in place, and closed once the graph holds a copy of it (words included)
+    MazeFile *saved = NULL;
+    MazeView view;
+    if (load_file)
+    {
+        saved = open_maze_file(load_file);
+        if (!saved || !get_maze_view(saved, level_id, &view))
+            return 1;
+    }
+
     SDL_Init(SDL_INIT_VIDEO);
     TTF_Init();
 
     SDL_Window *window = SDL_CreateWindow("Maze", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 800, 800, SDL_WINDOW_SHOWN);
-    SDL_Renderer *renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+    SDL_Renderer *renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
     TTF_Font *font = TTF_OpenFont("Arial.ttf", 24);
 
     if (!font)
@@ -1107,11 +1011,35 @@ int main(int argc, char *args[])
         return 1;
     }
 
-    int difficulty = show_menu(renderer, font, 800);
+    // Letters of the board, rasterized once
+    GlyphAtlas *atlas = create_glyph_atlas(renderer, font, (SDL_Color){0, 0, 0, 255});
+    if (!atlas)
+        return 1;
+
+    // Menu texts, rendered once per highlight state
+    TextCache *texts = create_text_cache(renderer, font);
+    if (!texts)
+        return 1;
+
+    if (survival)
+    {
+        printf("Seed: %llu\n", seed);
+        int score = play_survival(window, renderer, atlas, size_override ? size_override : SURVIVAL_WIDTH, seed);
+        printf("Score: %d\n", score);
+        free_text_cache(texts);
+        free_glyph_atlas(atlas);
+        SDL_DestroyRenderer(renderer);
+        SDL_DestroyWindow(window);
+        SDL_Quit();
+        return 0;
+    }
+
+    int difficulty = saved ? 0 : show_menu(renderer, texts, 800);
     printf("Selected difficulty: %d\n", difficulty);
 
     if (difficulty == -1)
     {
+        free_text_cache(texts);
         SDL_DestroyRenderer(renderer);
         SDL_DestroyWindow(window);
         SDL_Quit();
@@ -1132,52 +1060,175 @@ int main(int argc, char *args[])
         GRID_SIZE = 18;
         break;
     }
+    if (size_override)
+        GRID_SIZE = size_override;
+    if (saved)
+        GRID_SIZE = view.grid_size;
 
-    int WINDOW_SIZE = GRID_SIZE * CELL_SIZE;
+    // The window shows the whole board when it fits, the camera scrolls over the rest
+    int WINDOW_SIZE = SDL_min(GRID_SIZE * CELL_SIZE, 800);
     SDL_SetWindowSize(window, WINDOW_SIZE, WINDOW_SIZE);
 
-    Graph *graph = create_graph(GRID_SIZE);
-    initialize_graph(graph, GRID_SIZE);
-
-    // Load words from file
+    Graph *graph;
     char words[1000][20];
-    int word_count = load_words("dictionnaire.txt", words, 5);
-    const char *word_ptrs[5];
-    for (int i = 0; i < word_count; i++)
+    WordPosition *word_positions;
+    int actual_word_count = 0;
+    if (saved)
     {
-        word_ptrs[i] = words[i];
+        actual_word_count = view.header->word_count;
+        graph = graph_from_view(&view, &word_positions);
+        if (!graph)
+            return 1;
+        printf("Level %llu loaded from %s\n", level_id, load_file);
     }
-    WordPosition word_positions[5];
-    int actual_word_count = 0;
+    else
+    {
+        // Load words from file
+        int word_count = load_words("dictionnaire.txt", words, 5);
+        const char *word_ptrs[5];
+        for (int i = 0; i < word_count; i++)
+        {
+            word_ptrs[i] = words[i];
+        }
 
-    place_words(graph, word_ptrs, word_positions, &actual_word_count, word_count, GRID_SIZE);
+        // A small board may have no start and end far enough apart, the next seed is tried then
+        graph = NULL;
+        for (int attempt = 0; attempt < MAX_MAZE_ATTEMPTS; attempt++, seed++)
+        {
+            // Every random choice of the maze comes from this generator
+            MazeRng rng;
+            seed_rng(&rng, seed);
+            printf("Seed: %llu\n", seed);
 
-    divide_graph(graph, 0, 0, GRID_SIZE - 1, GRID_SIZE - 1, GRID_SIZE);
-    add_random_letters(graph, GRID_SIZE);
-    set_start_end(graph);
+            graph = graph ? reset_graph(graph, word_count, GRID_SIZE) : create_graph(word_count, GRID_SIZE);
+            initialize_graph(graph, GRID_SIZE);
 
-    char *path = find_shortest_path(graph, graph->start, graph->end, GRID_SIZE);
-    printf("Shortest MINIMAL path: %s\n", enlever_premier_dernier(path));
+            // Word positions live in the graph's arena, freed with it
+            word_positions = (WordPosition *)graph_alloc(graph, word_count * sizeof(WordPosition));
+            if (!word_positions)
+                return 1;
+            actual_word_count = 0;
+
+            place_words(graph, word_ptrs, word_positions, &actual_word_count, word_count, &rng, GRID_SIZE);
+
+            divide_graph(graph, 0, 0, GRID_SIZE - 1, GRID_SIZE - 1, &rng, GRID_SIZE);
+            add_random_letters(graph, &rng, GRID_SIZE);
+            if (set_start_end(graph, &rng))
+                break;
+        }
+        if (!graph->start)
+        {
+            printf("Erreur : aucun labyrinthe jouable de %dx%d\n", GRID_SIZE, GRID_SIZE);
+            return 1;
+        }
+    }
 
-    char *final_best_path = find_best_path(graph, word_positions, 5, GRID_SIZE);
-    printf("Final best path: %s\n", enlever_premier_dernier(final_best_path));
+    char *path = find_shortest_path(graph, graph->start, graph->end, GRID_SIZE);
+    char *letters = enlever_premier_dernier(path);
+    printf("Shortest MINIMAL path: %s\n", letters);
+    free(letters);
+    free(path);
+
+    char *final_best_path = find_best_path(graph, word_positions, actual_word_count, GRID_SIZE);
+    letters = enlever_premier_dernier(final_best_path);
+    printf("Final best path: %s\n", letters);
+    free(letters);
+
+    // Distance fields of the hint arrow (H), kept as long as this maze
+    HintFields *hints = NULL;
+    if (GRID_SIZE * GRID_SIZE <= MAX_HINT_CELLS)
+    {
+        hints = create_hint_fields(graph, word_positions, actual_word_count, GRID_SIZE);
+        printf("Press H to show or hide the hint arrow.\n");
+    }
+    else
+    {
+        printf("No hint arrow for boards over %d cells.\n", MAX_HINT_CELLS);
+    }
+    bool show_hint = false;
 
+    // A saved game goes on where it was left
     Player player;
-    initialize_player(&player, graph);
+    if (!saved || !restore_player(&view, graph, &player))
+        initialize_player(&player, graph);
+    close_maze_file(saved); // The graph holds its own copy of the level
+    printf("Press F5 to save the game in %s.\n", SAVE_FILE);
+
+    // Static board and visited overlay, drawn chunk by chunk as they come into view
+    MazeLayers *layers = create_maze_layers(renderer, graph, NULL, atlas, GRID_SIZE);
+    if (!layers)
+        return 1;
+
+    // View following the player, zoomed with keypad +/- or the mouse wheel
+    Camera camera = {0, 0, 1.0f, WINDOW_SIZE, WINDOW_SIZE};
+    zoom_camera(&camera, 1.0f);
+    printf("Press keypad + or - (or use the mouse wheel) to zoom.\n");
 
     Uint32 lastMoveTime = 0;
     Uint32 moveDelay = 150;
     int running = 1;
     SDL_Event event;
+    bool redraw = true; // Something on screen changed since the last present
+
+    // Loop statistics since the last report
+    Uint64 frame_ticks = 0; // Time spent drawing
+    Uint64 wait_ticks = 0;  // Time spent asleep in SDL_WaitEventTimeout
+    int frames = 0, wakeups = 0;
+    long frame_textures = textures_created;
+    Uint32 stats_time = SDL_GetTicks();
 
     while (running)
     {
-        while (SDL_PollEvent(&event))
+        // Sleep until an event comes, or until the next move is due while a move key is held
+        const Uint8 *keystate = SDL_GetKeyboardState(NULL);
+        bool move_key_held = false;
+        for (int k = 0; k < MOVE_KEY_COUNT; k++)
+            move_key_held = move_key_held || keystate[MOVE_KEYS[k].key];
+
+        int timeout = IDLE_WAIT_MS;
+        if (move_key_held)
+        {
+            Uint32 since_move = SDL_GetTicks() - lastMoveTime;
+            timeout = since_move > moveDelay ? 0 : (int)(moveDelay - since_move) + 1;
+        }
+
+        Uint64 wait_start = SDL_GetPerformanceCounter();
+        int has_event = SDL_WaitEventTimeout(&event, timeout);
+        wait_ticks += SDL_GetPerformanceCounter() - wait_start;
+        wakeups++;
+
+        // Handle that event and whatever else is queued
+        while (has_event)
         {
             if (event.type == SDL_QUIT)
             {
                 running = 0;
             }
+            else if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_h)
+            {
+                show_hint = !show_hint;
+                redraw = true;
+            }
+            else if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F5)
+            {
+                if (save_maze(SAVE_FILE, graph, word_positions, actual_word_count, &player, GRID_SIZE))
+                    printf("Game saved in %s (play it again with --load=%s)\n", SAVE_FILE, SAVE_FILE);
+            }
+            else if (event.type == SDL_KEYDOWN && (event.key.keysym.scancode == SDL_SCANCODE_KP_PLUS || event.key.keysym.scancode == SDL_SCANCODE_KP_MINUS))
+            {
+                zoom_camera(&camera, event.key.keysym.scancode == SDL_SCANCODE_KP_PLUS ? ZOOM_STEP : 1 / ZOOM_STEP);
+                redraw = true;
+            }
+            else if (event.type == SDL_MOUSEWHEEL && event.wheel.y != 0)
+            {
+                zoom_camera(&camera, event.wheel.y > 0 ? ZOOM_STEP : 1 / ZOOM_STEP);
+                redraw = true;
+            }
+            else if (event.type == SDL_RENDER_TARGETS_RESET)
+            {
+                invalidate_chunks(layers); // Target contents were lost, chunks are built again when drawn
+                redraw = true;
+            }
             else if (event.type == SDL_WINDOWEVENT)
             {
                 if (event.window.event == SDL_WINDOWEVENT_RESIZED)
@@ -1185,50 +1236,76 @@ int main(int argc, char *args[])
                     int new_width = event.window.data1;
                     int new_height = event.window.data2;
                     SDL_SetWindowSize(window, new_width, new_height);
+                    camera.width = new_width;
+                    camera.height = new_height;
+                    zoom_camera(&camera, 1.0f); // Keep the chunks in view within the cache
                 }
+                redraw = true; // Exposed, resized, restored...
             }
+            has_event = SDL_PollEvent(&event);
         }
 
         Uint32 currentTime = SDL_GetTicks();
         if (currentTime - lastMoveTime > moveDelay)
         {
-            const Uint8 *keystate = SDL_GetKeyboardState(NULL);
-
-            if (keystate[SDL_SCANCODE_KP_8])
-                move_player(&player, graph, -1, 0, GRID_SIZE);
-            if (keystate[SDL_SCANCODE_KP_2])
-                move_player(&player, graph, 1, 0, GRID_SIZE);
-            if (keystate[SDL_SCANCODE_KP_4])
-                move_player(&player, graph, 0, -1, GRID_SIZE);
-            if (keystate[SDL_SCANCODE_KP_6])
-                move_player(&player, graph, 0, 1, GRID_SIZE);
-            if (keystate[SDL_SCANCODE_KP_7])
-                move_player(&player, graph, -1, -1, GRID_SIZE);
-            if (keystate[SDL_SCANCODE_KP_9])
-                move_player(&player, graph, -1, 1, GRID_SIZE);
-            if (keystate[SDL_SCANCODE_KP_1])
-                move_player(&player, graph, 1, -1, GRID_SIZE);
-            if (keystate[SDL_SCANCODE_KP_3])
-                move_player(&player, graph, 1, 1, GRID_SIZE);
-
-            lastMoveTime = currentTime;
+            for (int k = 0; k < MOVE_KEY_COUNT; k++)
+            {
+                if (!keystate[MOVE_KEYS[k].key])
+                    continue;
+
+                move_player(&player, graph, MOVE_KEYS[k].dx, MOVE_KEYS[k].dy, GRID_SIZE);
+                mark_visited_cell(layers, &graph->nodes[player.x * GRID_SIZE + player.y]); // Only the cell moved to changes
+                redraw = true;
+                lastMoveTime = currentTime; // The move timer only runs while moving
+            }
         }
 
         // Check if player reached the end point
         if (player.x == graph->end->x && player.y == graph->end->y)
         {
             printf("Congratulations! You've reached the end point.\n");
-            int score = calculate_score(player.path, word_positions, 5, strlen(final_best_path) - 2);
+            int score = calculate_score(player.path, word_positions, actual_word_count, strlen(final_best_path) - 2);
             printf("Score: %d\n", score);
             running = 0;
         }
 
-        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-        SDL_RenderClear(renderer);
-        draw_graph(renderer, graph, &player, font, GRID_SIZE);
-        SDL_RenderPresent(renderer);
+        // Present only when something changed (waits for vsync)
+        if (redraw)
+        {
+            Uint64 frame_start = SDL_GetPerformanceCounter();
+            SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+            SDL_RenderClear(renderer);
+            follow_player(&camera, &player, GRID_SIZE, GRID_SIZE);
+            draw_graph(renderer, graph, &player, layers, &camera, show_hint ? hints : NULL, GRID_SIZE);
+            SDL_RenderPresent(renderer);
+            frame_ticks += SDL_GetPerformanceCounter() - frame_start;
+            frames++;
+            redraw = false;
+        }
+
+        Uint32 elapsed = SDL_GetTicks() - stats_time;
+        if (frame_stats && elapsed >= FRAME_STATS_INTERVAL)
+        {
+            double seconds = elapsed / 1000.0;
+            double frequency = (double)SDL_GetPerformanceFrequency();
+            printf("Loop: %.1f frames/s (%.3f ms each), %.1f wake-ups/s, awake %.1f%% of the time, %.1f textures created per frame\n",
+                   frames / seconds, frames ? 1000.0 * frame_ticks / frequency / frames : 0.0, wakeups / seconds,
+                   100.0 * (1.0 - wait_ticks / frequency / seconds), frames ? (double)(textures_created - frame_textures) / frames : 0.0);
+            frame_ticks = 0;
+            wait_ticks = 0;
+            frames = 0;
+            wakeups = 0;
+            frame_textures = textures_created;
+            stats_time = SDL_GetTicks();
+        }
     }
 
+    free_hint_fields(hints);
+    free(final_best_path);
+    destroy_graph(graph);
+    free_text_cache(texts);
+    free_maze_layers(layers);
+    free_glyph_atlas(atlas);
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     SDL_Quit();
@@ -0,0 +1,252 @@
+#include "maze_core.h"
+#include "maze_file.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+
+// Headless batch generator: builds count levels, from seeds first_seed to first_seed + count - 1,
+// on a pool of worker threads that take one level at a time, and reports the throughput.
+// Usage: maze_batch [--count=N] [--size=N] [--words=N] [--seed=N] [--threads=N] [--scaling] [--list]
+//                   [--output=file] [--engine=name] [--dictionary=file]
+// --scaling builds the batch again with 1, 2, 4... threads up to every core and prints the
+// mazes/s of each. --list prints the summary of every level. A level only depends on its seed,
+// so the checksum of the batch is the same whatever the number of threads.
+// --output writes the levels to an archive (see maze_file.h), the id of a level being its seed
+// (with --scaling, during a first run that is not timed).
+
+#define BATCH_MAX_THREADS 256
+
+typedef struct
+{
+    int words_placed;
+    int best_length; // Letters in the best path, -1 if there is none
+    uint32_t checksum;
+} LevelSummary;
+
+typedef struct
+{
+    int grid_size;
+    int word_count;
+    int count;
+    uint64_t first_seed;
+    const char **words;
+    LevelSummary *levels;       // One per level, filled by the workers
+    MazeArchiveWriter *archive; // NULL when the levels are not kept
+    pthread_mutex_t archive_lock;
+    atomic_int next; // Next level to build
+} BatchJob;
+
+// FNV-1a hash of a string, starting from hash
+uint32_t hash_string(uint32_t hash, const char *text)
+{
+    for (; *text; text++)
+        hash = (hash ^ (unsigned char)*text) * 16777619u;
+    return hash;
+}
+
+// Build level index of the job the way the game does in graph, emptied first, and keep its summary.
+// Returns the graph, which is the same one unless it had to grow.
+Graph *build_level(BatchJob *job, int index, Graph *graph)
+{
+    int GRID_SIZE = job->grid_size;
+    WordPosition word_positions[job->word_count > 0 ? job->word_count : 1];
+    int placed = 0;
+    MazeRng rng;
+    seed_rng(&rng, job->first_seed + index);
+
+    graph = reset_graph(graph, job->word_count, GRID_SIZE);
+    initialize_graph(graph, GRID_SIZE);
+    place_words(graph, job->words, word_positions, &placed, job->word_count, &rng, GRID_SIZE);
+    divide_graph(graph, 0, 0, GRID_SIZE - 1, GRID_SIZE - 1, &rng, GRID_SIZE);
+    add_random_letters(graph, &rng, GRID_SIZE);
+    // A level without start and end (small grids) has no best path and is left out of the archive
+    bool playable = set_start_end(graph, &rng);
+    if (!playable)
+        printf("Erreur : pas de départ et d'arrivée assez éloignés pour le niveau %llu\n",
+               (unsigned long long)(job->first_seed + index));
+    char *best_path = playable ? find_best_path(graph, word_positions, placed, GRID_SIZE) : NULL;
+
+    LevelSummary *level = &job->levels[index];
+    level->words_placed = placed;
+    level->best_length = best_path ? (int)strlen(best_path) : -1;
+    level->checksum = hash_string(2166136261u, best_path ? best_path : "");
+    free(best_path);
+
+    if (job->archive && playable)
+    {
+        pthread_mutex_lock(&job->archive_lock);
+        add_archive_maze(job->archive, job->first_seed + index, graph, word_positions, placed, GRID_SIZE);
+        pthread_mutex_unlock(&job->archive_lock);
+    }
+    return graph;
+}
+
+void *batch_worker(void *argument)
+{
+    BatchJob *job = (BatchJob *)argument;
+    // One graph per worker, reset for each of its levels
+    Graph *graph = create_graph(job->word_count, job->grid_size);
+    for (int index = atomic_fetch_add(&job->next, 1); index < job->count; index = atomic_fetch_add(&job->next, 1))
+        graph = build_level(job, index, graph);
+    destroy_graph(graph);
+    free_solver_scratch();
+    return NULL;
+}
+
+// Build every level of the job on thread_count threads. Returns the seconds taken, or -1 if no
+// thread could be started.
+double run_batch(BatchJob *job, int thread_count)
+{
+    pthread_t threads[BATCH_MAX_THREADS];
+    atomic_store(&job->next, 0);
+
+    double begin = wall_seconds();
+    int started = 0;
+    while (started < thread_count && pthread_create(&threads[started], NULL, batch_worker, job) == 0)
+        started++;
+    if (started == 0)
+    {
+        printf("Erreur : impossible de créer les threads\n");
+        return -1;
+    }
+    for (int t = 0; t < started; t++)
+        pthread_join(threads[t], NULL);
+    return wall_seconds() - begin;
+}
+
+// Checksum of every level, in seed order
+uint32_t batch_checksum(BatchJob *job)
+{
+    uint32_t hash = 2166136261u;
+    for (int i = 0; i < job->count; i++)
+        hash = (hash ^ job->levels[i].checksum) * 16777619u;
+    return hash;
+}
+
+int online_cores(void)
+{
+#ifdef _SC_NPROCESSORS_ONLN
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    return cores < 1 ? 1 : cores > BATCH_MAX_THREADS ? BATCH_MAX_THREADS : (int)cores;
+#else
+    return 1;
+#endif
+}
+
+int main(int argc, char *args[])
+{
+    int count = 100, grid_size = 64, word_count = 5, thread_count = online_cores();
+    unsigned long long first_seed = 0;
+    bool scaling = false, list = false;
+    const char *dictionary = "dictionnaire.txt";
+    const char *output = NULL;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(args[i], "--count=", 8) == 0)
+            count = atoi(args[i] + 8);
+        else if (strncmp(args[i], "--size=", 7) == 0)
+            grid_size = atoi(args[i] + 7);
+        else if (strncmp(args[i], "--words=", 8) == 0)
+            word_count = atoi(args[i] + 8);
+        else if (strncmp(args[i], "--seed=", 7) == 0)
+            first_seed = strtoull(args[i] + 7, NULL, 10);
+        else if (strncmp(args[i], "--threads=", 10) == 0)
+            thread_count = atoi(args[i] + 10);
+        else if (strcmp(args[i], "--scaling") == 0)
+            scaling = true;
+        else if (strcmp(args[i], "--list") == 0)
+            list = true;
+        else if (strncmp(args[i], "--output=", 9) == 0)
+            output = args[i] + 9;
+        else if (strncmp(args[i], "--dictionary=", 13) == 0)
+            dictionary = args[i] + 13;
+        else if (strncmp(args[i], "--engine=", 9) == 0 && parse_engine(args[i] + 9) >= 0)
+            solver_engine = parse_engine(args[i] + 9);
+        else
+        {
+            printf("Erreur : option invalide %s\n", args[i]);
+            return 1;
+        }
+    }
+    if (count < 1 || grid_size < 5 || word_count < 0 || word_count > 1000 || thread_count < 1 || thread_count > BATCH_MAX_THREADS)
+    {
+        printf("Erreur : il faut count >= 1, size >= 5, 0 <= words <= 1000 et 1 <= threads <= %d\n", BATCH_MAX_THREADS);
+        return 1;
+    }
+
+    static char words[1000][20];
+    const char *word_ptrs[1000];
+    int word_total = load_words(dictionary, words, word_count);
+    for (int i = 0; i < word_total; i++)
+        word_ptrs[i] = words[i];
+
+    BatchJob job = {grid_size, word_total, count, first_seed, word_ptrs, NULL, NULL, PTHREAD_MUTEX_INITIALIZER, 0};
+    job.levels = (LevelSummary *)calloc(count, sizeof(LevelSummary));
+    if (!job.levels)
+    {
+        printf("Memory allocation failed.\n");
+        return 1;
+    }
+    if (output)
+    {
+        job.archive = create_maze_archive(output, first_seed, count);
+        if (!job.archive)
+            return 1;
+    }
+    MazeArchiveWriter *archive = job.archive;
+
+    maze_verbose = false; // Only the report
+    if (scaling)
+    {
+        printf("%d mazes of %dx%d with %d words, seeds %llu to %llu\n", count, grid_size, grid_size, word_total, first_seed,
+               first_seed + count - 1);
+        printf("threads\tseconds\tmazes/s\tspeedup\tefficiency\tsame levels\n");
+        double single = 0;
+        uint32_t reference = 0;
+        if (job.archive && run_batch(&job, thread_count) < 0)
+            return 1;
+        job.archive = NULL;
+        for (int threads = 1;; threads = threads * 2 < thread_count ? threads * 2 : thread_count)
+        {
+            double elapsed = run_batch(&job, threads);
+            if (elapsed < 0)
+                return 1;
+            uint32_t checksum = batch_checksum(&job);
+            if (threads == 1)
+            {
+                single = elapsed;
+                reference = checksum;
+            }
+            printf("%d\t%.3f\t%.1f\t%.2f\t%.0f%%\t%s\n", threads, elapsed, count / elapsed, single / elapsed,
+                   100.0 * single / elapsed / threads, checksum == reference ? "yes" : "NO");
+            if (threads == thread_count)
+                break;
+        }
+    }
+    else
+    {
+        double elapsed = run_batch(&job, thread_count);
+        if (elapsed < 0)
+            return 1;
+        printf("%d mazes of %dx%d with %d words in %.3f s on %d threads: %.1f mazes/s (checksum %08x)\n", count, grid_size,
+               grid_size, word_total, elapsed, thread_count, count / elapsed, batch_checksum(&job));
+    }
+
+    if (archive)
+    {
+        pthread_mutex_destroy(&job.archive_lock);
+        if (!close_maze_archive(archive))
+            return 1;
+        printf("Levels %llu to %llu written to %s\n", first_seed, first_seed + count - 1, output);
+    }
+
+    if (list)
+    {
+        printf("seed\twords\tbest path\tchecksum\n");
+        for (int i = 0; i < count; i++)
+            printf("%llu\t%d\t%d\t%08x\n", first_seed + i, job.levels[i].words_placed, job.levels[i].best_length,
+                   job.levels[i].checksum);
+    }
+    free(job.levels);
+    return 0;
+}
@@ -0,0 +1,195 @@
+#include "maze_core.h"
+
+// Headless end-to-end benchmark: times every stage of building a level (generation, word
+// placement, solving, word ordering) for several grid sizes and word counts, and prints the
+// median, 99th percentile and cells per second of each stage as JSON on stdout.
+// Usage: maze_bench [--engine=name] [--runs=N] [--max-size=N] [--dictionary=file]
+// Repetitions are generated from seeds 0, 1, 2... (skipping the ones without start and end), so runs
+// time the same mazes.
+
+#define BENCH_MAX_WORDS 10
+
+enum
+{
+    STAGE_INITIALIZE_GRAPH,
+    STAGE_PLACE_WORDS,
+    STAGE_DIVIDE_GRAPH,
+    STAGE_ADD_RANDOM_LETTERS,
+    STAGE_SET_START_END,
+    STAGE_FIND_SHORTEST_PATH,
+    STAGE_FIND_BEST_PATH,
+    STAGE_TOTAL,
+    STAGE_COUNT
+};
+
+const char *STAGE_NAMES[STAGE_COUNT] = {"initialize_graph", "place_words", "divide_graph", "add_random_letters",
+                                        "set_start_end", "find_shortest_path", "find_best_path", "total"};
+
+int compare_doubles(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Value at fraction (0..1) of the sorted samples, nearest rank
+double percentile(const double *sorted, int count, double fraction)
+{
+    int rank = (int)(fraction * count + 0.999999);
+    return sorted[rank < 1 ? 0 : rank > count ? count - 1 : rank - 1];
+}
+
+// Build one level the way the game does, with the seconds of every stage in times (one entry per
+// stage). Returns the number of words placed, or -1 if the maze has no start and end far enough
+// apart (small grids), and then its solve stages are not timed.
+int build_level(int GRID_SIZE, const char **words, int word_count, uint64_t seed, double *times)
+{
+    WordPosition word_positions[BENCH_MAX_WORDS];
+    int placed = 0;
+    Graph *graph = create_graph(word_count, GRID_SIZE);
+    MazeRng rng;
+    seed_rng(&rng, seed);
+
+    double t0 = wall_seconds();
+    initialize_graph(graph, GRID_SIZE);
+    double t1 = wall_seconds();
+    place_words(graph, words, word_positions, &placed, word_count, &rng, GRID_SIZE);
+    double t2 = wall_seconds();
+    divide_graph(graph, 0, 0, GRID_SIZE - 1, GRID_SIZE - 1, &rng, GRID_SIZE);
+    double t3 = wall_seconds();
+    add_random_letters(graph, &rng, GRID_SIZE);
+    double t4 = wall_seconds();
+    if (!set_start_end(graph, &rng))
+    {
+        destroy_graph(graph);
+        return -1;
+    }
+    double t5 = wall_seconds();
+    char *path = find_shortest_path(graph, graph->start, graph->end, GRID_SIZE);
+    double t6 = wall_seconds();
+    char *best_path = find_best_path(graph, word_positions, placed, GRID_SIZE);
+    double t7 = wall_seconds();
+
+    times[STAGE_INITIALIZE_GRAPH] = t1 - t0;
+    times[STAGE_PLACE_WORDS] = t2 - t1;
+    times[STAGE_DIVIDE_GRAPH] = t3 - t2;
+    times[STAGE_ADD_RANDOM_LETTERS] = t4 - t3;
+    times[STAGE_SET_START_END] = t5 - t4;
+    times[STAGE_FIND_SHORTEST_PATH] = t6 - t5;
+    times[STAGE_FIND_BEST_PATH] = t7 - t6;
+    times[STAGE_TOTAL] = t7 - t0;
+
+    free(path);
+    free(best_path);
+    destroy_graph(graph);
+    return placed;
+}
+
+// Time runs levels of one configuration (after one warm-up level) and print its JSON object
+bool run_configuration(int GRID_SIZE, const char **words, int word_count, int runs, bool first)
+{
+    double *samples = (double *)malloc((size_t)STAGE_COUNT * runs * sizeof(double));
+    if (!samples)
+    {
+        printf("Memory allocation failed.\n");
+        return false;
+    }
+
+    double times[STAGE_COUNT];
+    build_level(GRID_SIZE, words, word_count, runs, times); // Warm up, not timed
+
+    // A seed without a playable maze is skipped, so every run times a whole level
+    int placed = 0;
+    for (int r = 0, seed = 0; r < runs; r++, seed++)
+    {
+        int level_placed;
+        while ((level_placed = build_level(GRID_SIZE, words, word_count, seed, times)) < 0)
+            seed++;
+        placed += level_placed;
+        for (int s = 0; s < STAGE_COUNT; s++)
+            samples[s * runs + r] = times[s];
+    }
+
+    int cells = GRID_SIZE * GRID_SIZE;
+    printf("%s\n    {\"grid\": %d, \"cells\": %d, \"words\": %d, \"words_placed\": %.2f, \"runs\": %d, \"stages\": {",
+           first ? "" : ",", GRID_SIZE, cells, word_count, (double)placed / runs, runs);
+    for (int s = 0; s < STAGE_COUNT; s++)
+    {
+        double *stage = samples + s * runs;
+        qsort(stage, runs, sizeof(double), compare_doubles);
+        double median = percentile(stage, runs, 0.5), p99 = percentile(stage, runs, 0.99);
+        printf("%s\n      \"%s\": {\"median_us\": %.3f, \"p99_us\": %.3f, \"cells_per_sec\": %.0f}", s ? "," : "",
+               STAGE_NAMES[s], median * 1e6, p99 * 1e6, median > 0 ? cells / median : 0.0);
+    }
+    printf("\n    }}");
+    fflush(stdout);
+    free(samples);
+    return true;
+}
+
+int main(int argc, char *args[])
+{
+    int runs = 0; // 0: chosen from the grid size
+    int max_size = INT_MAX;
+    const char *dictionary = "dictionnaire.txt";
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(args[i], "--engine=", 9) == 0)
+        {
+            int engine = parse_engine(args[i] + 9);
+            if (engine < 0)
+            {
+                printf("Erreur : moteur inconnu %s\n", args[i] + 9);
+                return 1;
+            }
+            solver_engine = engine;
+        }
+        else if (strncmp(args[i], "--runs=", 7) == 0)
+        {
+            runs = atoi(args[i] + 7);
+        }
+        else if (strncmp(args[i], "--max-size=", 11) == 0)
+        {
+            max_size = atoi(args[i] + 11);
+        }
+        else if (strncmp(args[i], "--dictionary=", 13) == 0)
+        {
+            dictionary = args[i] + 13;
+        }
+        else
+        {
+            printf("Erreur : option inconnue %s\n", args[i]);
+            return 1;
+        }
+    }
+
+    char words[BENCH_MAX_WORDS][20];
+    int word_total = load_words(dictionary, words, BENCH_MAX_WORDS);
+    const char *word_ptrs[BENCH_MAX_WORDS];
+    for (int i = 0; i < word_total; i++)
+        word_ptrs[i] = words[i];
+
+    int sizes[] = {10, 15, 18, 64, 256, 1024};
+    int size_count = sizeof(sizes) / sizeof(sizes[0]);
+    int word_counts[] = {1, 5, BENCH_MAX_WORDS};
+    int word_count_count = sizeof(word_counts) / sizeof(word_counts[0]);
+
+    maze_verbose = false; // Only JSON on stdout
+    printf("{\n  \"benchmark\": \"maze_bench\",\n  \"engine\": \"%s\",\n  \"results\": [", ENGINE_NAMES[solver_engine]);
+    bool first = true;
+    for (int s = 0; s < size_count && sizes[s] <= max_size; s++)
+    {
+        // Enough runs for a stable median on the small grids, a few on the big ones
+        int size_runs = runs > 0 ? runs : 4000000 / (sizes[s] * sizes[s]) + 5;
+        if (size_runs > 500)
+            size_runs = 500;
+        for (int w = 0; w < word_count_count; w++)
+        {
+            int word_count = word_counts[w] < word_total ? word_counts[w] : word_total;
+            if (!run_configuration(sizes[s], word_ptrs, word_count, size_runs, first))
+                return 1;
+            first = false;
+        }
+    }
+    printf("\n  ]\n}\n");
+    return 0;
+}
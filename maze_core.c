@@ -0,0 +1,2394 @@
+#include "maze_core.h"
+
+// Vector width of the bitboard solver: 256 cells per step with -mavx2, 128 with SSE2
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Memory per cell: the graph keeps 12 bytes (Node) in its arena. Scratch memory is sized from the
+// grid on the heap and only lives during the call, except where noted. find_shortest_path, by engine:
+//   bfs (default)    4 bytes of distance and 4 of queue
+//   dijkstra, astar  4 bytes of distance, and 12 bytes per heap entry: stale entries stay in the
+//                    heap (lazy deletion), so a cell can have several and the heap has no fixed bound
+//   jps              as astar, plus 4 bytes of parent
+//   bitboard         4 bytes of distance and 5 bit planes (under 1 byte)
+//   bidirectional    16 bytes, kept between queries (see BidirectionalScratch)
+// set_start_end uses 4 bytes. find_best_path uses 8 bytes for its searches and 1 byte for each
+// waypoint (2 per word, plus start and end). The hint fields keep 4 bytes for each of their
+// 1 + 2 * word_count fields for as long as the level is played (see create_hint_fields).
+
+// Binary min-heap on distance, grown on demand
+typedef struct PriorityQueue
+{
+    Node **nodes;
+    int *distances;
+    int size;
+    int capacity;
+} PriorityQueue;
+
+const char *ENGINE_NAMES[ENGINE_COUNT] = {"dijkstra", "bfs", "astar", "bitboard", "jps", "bidirectional"};
+
+// Default engine, can be changed at build time (-DSOLVER_ENGINE=ENGINE_BFS) or with --engine=
+#ifndef SOLVER_ENGINE
+#define SOLVER_ENGINE ENGINE_BFS
+#endif
+
+SolverEngine solver_engine = SOLVER_ENGINE;
+_Thread_local long solver_expansions = 0;
+bool maze_verbose = true;
+
+// Direction index of the step (dx, dy), or -1 if it is not a step to an adjacent cell
+int get_direction(int dx, int dy)
+{
+    if (dx < -1 || dx > 1 || dy < -1 || dy > 1 || (dx == 0 && dy == 0))
+        return -1;
+    int index = (dx + 1) * 3 + (dy + 1);
+    return index < 4 ? index : index - 1;
+}
+
+// Neighbor of a node in the given direction (the caller checks the mask or the bounds)
+Node *get_neighbor(Graph *graph, Node *node, int direction, int GRID_SIZE)
+{
+    return &graph->nodes[(node->x + DIR_DX[direction]) * GRID_SIZE + node->y + DIR_DY[direction]];
+}
+
+// xoshiro128** (Blackman and Vigna). The 128-bit state is filled from the seed with splitmix64,
+// so neighboring seeds give unrelated sequences.
+void seed_rng(MazeRng *rng, uint64_t seed)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        rng->state[i] = (uint32_t)((z ^ (z >> 31)) >> 32);
+    }
+}
+
+uint32_t rng_next(MazeRng *rng)
+{
+    uint32_t *s = rng->state;
+    uint32_t x = s[1] * 5;
+    uint32_t result = ((x << 7) | (x >> 25)) * 9;
+    uint32_t t = s[1] << 9;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = (s[3] << 11) | (s[3] >> 21);
+    return result;
+}
+
+// Random integer in [0, bound), by multiplying instead of dividing (bound > 0)
+int rng_below(MazeRng *rng, int bound)
+{
+    return (int)(((uint64_t)rng_next(rng) * (uint32_t)bound) >> 32);
+}
+
+// Create graph for up to word_count words (nodes are stored in the same allocation)
+Graph *create_graph(int word_count, int GRID_SIZE)
+{
+    Graph *graph = allocate_graph(word_count, GRID_SIZE);
+    if (!graph)
+    {
+        printf("Memory allocation error for graph.\n");
+        exit(1);
+    }
+    return graph;
+}
+
+// Same as create_graph, but NULL when there is not enough memory, for callers that can go on
+Graph *allocate_graph(int word_count, int GRID_SIZE)
+{
+    size_t arena_size = (size_t)GRID_SIZE * GRID_SIZE * sizeof(Node) + GRAPH_WORD_BYTES(word_count);
+    Graph *graph = (Graph *)malloc(sizeof(Graph) + arena_size);
+    if (!graph)
+        return NULL;
+    graph->nodes = (Node *)(graph + 1);
+    graph->arena_size = arena_size;
+    return reset_graph(graph, word_count, GRID_SIZE);
+}
+
+// Empty a graph for a new maze of GRID_SIZE with up to word_count words: its nodes and words are
+// gone, and its arena is reused without allocating when the new maze is not larger than the one it
+// was made for. Returns the graph, or a new one if a bigger arena was needed (the old one is freed).
+Graph *reset_graph(Graph *graph, int word_count, int GRID_SIZE)
+{
+    size_t node_bytes = (size_t)GRID_SIZE * GRID_SIZE * sizeof(Node);
+    if (node_bytes + GRAPH_WORD_BYTES(word_count) > graph->arena_size)
+    {
+        destroy_graph(graph);
+        return create_graph(word_count, GRID_SIZE);
+    }
+
+    graph->node_count = 0;
+    graph->start = NULL;
+    graph->end = NULL;
+    graph->arena_used = node_bytes;
+    return graph;
+}
+
+// Free a graph with everything in its arena
+void destroy_graph(Graph *graph)
+{
+    free(graph);
+}
+
+// Memory from the graph's arena (8-byte aligned), for as long as the maze lives: it is not freed on
+// its own. NULL when the arena is full.
+void *graph_alloc(Graph *graph, size_t size)
+{
+    size_t offset = (graph->arena_used + 7) & ~(size_t)7;
+    if (offset > graph->arena_size || size > graph->arena_size - offset)
+        return NULL;
+
+    graph->arena_used = offset + size;
+    return (char *)graph->nodes + offset;
+}
+
+// Add an edge
+void add_edge(Node *node1, Node *node2)
+{
+    int direction = get_direction(node2->x - node1->x, node2->y - node1->y);
+
+    // Only adjacent cells can be connected (this also avoids self-loops)
+    if (direction < 0)
+        return;
+
+    node1->neighbors |= 1 << direction;
+    node2->neighbors |= 1 << (DIR_COUNT - 1 - direction);
+}
+
+void print_neighbors(Graph *graph, int GRID_SIZE)
+{
+    for (int x = 0; x < GRID_SIZE; x++)
+    {
+        for (int y = 0; y < GRID_SIZE; y++)
+        {
+            Node *node = &graph->nodes[x * GRID_SIZE + y];
+            printf("Node (%d, %d) Letter %c has %d neighbors: ", x, y, node->letter, __builtin_popcount(node->neighbors));
+            for (int d = 0; d < DIR_COUNT; d++)
+            {
+                if (node->neighbors & (1 << d))
+                    printf("(%d, %d) ", x + DIR_DX[d], y + DIR_DY[d]);
+            }
+            printf("\n");
+        }
+    }
+}
+
+// Initialize the graph
+void initialize_graph(Graph *graph, int GRID_SIZE)
+{
+    graph->node_count = GRID_SIZE * GRID_SIZE;
+
+    for (int x = 0; x < GRID_SIZE; x++)
+    {
+        for (int y = 0; y < GRID_SIZE; y++)
+        {
+            Node *node = &graph->nodes[x * GRID_SIZE + y];
+            node->x = x;
+            node->y = y;
+            node->neighbors = 0;
+            node->letter = ' '; // Initialize as empty space
+            node->visited = false;
+            node->is_part_of_word = false;
+
+            // Connect to every adjacent cell inside the grid, diagonals included
+            for (int d = 0; d < DIR_COUNT; d++)
+            {
+                int nx = x + DIR_DX[d];
+                int ny = y + DIR_DY[d];
+                if (nx >= 0 && nx < GRID_SIZE && ny >= 0 && ny < GRID_SIZE)
+                    node->neighbors |= 1 << d;
+            }
+        }
+    }
+}
+
+// Set start and end points, at least 5 cells apart. Returns false (start and end left NULL) when
+// the maze has no such pair for the start drawn, which happens on the smallest grids.
+bool set_start_end(Graph *graph, MazeRng *rng)
+{
+    int *valid_nodes = (int *)malloc(graph->node_count * sizeof(int)); // Indices of valid nodes
+    int valid_count = 0;
+    if (!valid_nodes)
+    {
+        printf("Memory allocation failed!\n");
+        return false;
+    }
+
+    // Collect all valid nodes (not walls, empty spaces, or part of a word)
+    for (int i = 0; i < graph->node_count; i++)
+    {
+        // printf("Node letter: %c\n and is_part_of_word: %d\n", graph->nodes[i].letter, graph->nodes[i].is_part_of_word);
+        if (graph->nodes[i].letter != '#' && graph->nodes[i].letter != ' ' && !graph->nodes[i].is_part_of_word)
+        {
+            valid_nodes[valid_count++] = i;
+        }
+    }
+
+    // Ensure there are at least 2 valid nodes (start and end)
+    if (valid_count < 2)
+    {
+        // printf("Error: Not enough valid nodes for start and end!\n");
+        free(valid_nodes);
+        return false;
+    }
+
+    // Select start position randomly from valid nodes
+    Node *start = &graph->nodes[valid_nodes[rng_below(rng, valid_count)]];
+
+    // The end is drawn until it is far enough, so there must be a node that is
+    bool reachable = false;
+    for (int i = 0; i < valid_count && !reachable; i++)
+    {
+        Node *node = &graph->nodes[valid_nodes[i]];
+        reachable = abs(node->x - start->x) + abs(node->y - start->y) >= 5;
+    }
+    if (!reachable)
+    {
+        free(valid_nodes);
+        return false;
+    }
+    graph->start = start;
+
+    // Select end position ensuring minimum distance of 5
+    do
+    {
+        graph->end = &graph->nodes[valid_nodes[rng_below(rng, valid_count)]];
+    } while (graph->end == graph->start ||
+             abs(graph->end->x - graph->start->x) + abs(graph->end->y - graph->start->y) < 5);
+    free(valid_nodes);
+
+    if (maze_verbose)
+        printf("Start: (%d, %d), End: (%d, %d)\n", graph->start->x, graph->start->y, graph->end->x, graph->end->y);
+    return true;
+}
+
+// Charge un dictionnaire de mots depuis un fichier
+int load_words(const char *filename, char words[][20], int max_words)
+{
+    FILE *file = fopen(filename, "r");
+    if (!file)
+    {
+        printf("Erreur : impossible d'ouvrir le fichier %s\n", filename);
+        return 0;
+    }
+
+    int count = 0;
+    while (count < max_words && fscanf(file, "%19s", words[count]) == 1)
+    {
+        count++;
+    }
+
+    fclose(file);
+    return count;
+}
+
+int can_place_word(Graph *graph, const char *word, int x, int y, int horizontal, int GRID_SIZE)
+{
+    int len = strlen(word);
+    if (horizontal)
+    {
+        if (y + len > GRID_SIZE)
+            return 0;
+        for (int i = 0; i < len; i++)
+        {
+            Node *node = &graph->nodes[x * GRID_SIZE + y + i];
+            if (node->letter != ' ' && node->letter != word[i])
+                return 0;
+        }
+    }
+    else
+    {
+        if (x + len > GRID_SIZE)
+            return 0;
+        for (int i = 0; i < len; i++)
+        {
+            Node *node = &graph->nodes[(x + i) * GRID_SIZE + y];
+            if (node->letter != ' ' && node->letter != word[i])
+                return 0;
+        }
+    }
+    return 1;
+}
+
+int try_place_word(Graph *graph, const char *word, WordPosition *word_positions, int *word_count, MazeRng *rng, int GRID_SIZE)
+{
+    int len = strlen(word);
+    int attempts = 100;
+
+    while (attempts-- > 0)
+    {
+        int horizontal = rng_below(rng, 2);
+        int x = rng_below(rng, GRID_SIZE);
+        int y = rng_below(rng, GRID_SIZE);
+
+        if (can_place_word(graph, word, x, y, horizontal, GRID_SIZE))
+        {
+            // The word positions keep a copy of the word owned by the graph
+            char *text = (char *)graph_alloc(graph, len + 1);
+            if (!text)
+            {
+                // More or longer words than the graph was made for
+                printf("Erreur : plus de place dans le labyrinthe pour le mot %s\n", word);
+                return 0;
+            }
+            memcpy(text, word, len + 1);
+
+            // Place the word on the grid
+            for (int i = 0; i < len; i++)
+            {
+                Node *node = &graph->nodes[(horizontal ? x : x + i) * GRID_SIZE + (horizontal ? y + i : y)];
+                node->letter = word[i];
+                node->is_part_of_word = true;
+            }
+
+            // Save the position and information of the word
+            word_positions[*word_count].word = text;
+            word_positions[*word_count].direction = horizontal;
+            word_positions[*word_count].length = len;
+
+            // Store the start position (x, y) of the word
+            word_positions[*word_count].startX = x;
+            word_positions[*word_count].startY = y;
+
+            // Calculate the end position based on direction and word length
+            if (horizontal)
+            {
+                word_positions[*word_count].endX = x;
+                word_positions[*word_count].endY = y + len - 1;
+            }
+            else
+            {
+                word_positions[*word_count].endX = x + len - 1;
+                word_positions[*word_count].endY = y;
+            }
+
+            // Increment the word count
+            (*word_count)++;
+
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void place_words(Graph *graph, const char *words[], WordPosition *word_positions, int *word_count, int word_count_total, MazeRng *rng, int GRID_SIZE)
+{
+    for (int i = 0; i < word_count_total; i++)
+    {
+        if (!try_place_word(graph, words[i], word_positions, word_count, rng, GRID_SIZE) && maze_verbose)
+        {
+            printf("⚠️ Impossible de placer le mot: %s\n", words[i]);
+        }
+    }
+}
+
+// Initialize the player
+void initialize_player(Player *player, Graph *graph)
+{
+    player->x = graph->start->x;
+    player->y = graph->start->y;
+    player->score = 0;
+    player->path[0] = '\0';
+}
+
+// Move the player
+// Update the move_player function
+void move_player(Player *player, Graph *graph, int dx, int dy, int GRID_SIZE)
+{
+    int direction = get_direction(dx, dy);
+    Node *current = &graph->nodes[player->x * GRID_SIZE + player->y];
+
+    // The move is allowed only if the edge in that direction is still open
+    if (direction < 0 || !(current->neighbors & (1 << direction)))
+        return;
+
+    visit_cell(player, get_neighbor(graph, current, direction, GRID_SIZE));
+}
+
+// Put the player on node, collecting its letter
+void visit_cell(Player *player, Node *node)
+{
+    player->x = node->x;
+    player->y = node->y;
+    node->visited = true;
+    // Check if the player collects a letter
+    if (node->letter != ' ')
+    {
+        // player->score += 10;  // Increase score when collecting a letter
+        // node->letter = ' ';
+        // add the letter to the player path (as long as it fits)
+        size_t length = strlen(player->path);
+        if (length < sizeof(player->path) - 1)
+        {
+            player->path[length] = node->letter;
+            player->path[length + 1] = '\0';
+        }
+    }
+}
+
+// Function to remove an edge between two nodes
+void remove_edge(Node *node1, Node *node2)
+{
+    int direction = get_direction(node2->x - node1->x, node2->y - node1->y);
+    if (direction < 0)
+        return;
+
+    node1->neighbors &= ~(1 << direction);
+    node2->neighbors &= ~(1 << (DIR_COUNT - 1 - direction));
+}
+
+// Turn an empty cell into a wall: clear its edges, and the edge back to it in each open neighbor.
+// offsets[d] is the index offset of the neighbor in direction d.
+void build_wall_cell(Node *nodes, int index, const int *offsets)
+{
+    Node *node = &nodes[index];
+    if (node->letter != ' ')
+        return; // Letters of the words stay open
+
+    node->letter = '#';
+    for (unsigned int open = node->neighbors; open; open &= open - 1)
+    {
+        int d = __builtin_ctz(open);
+        nodes[index + offsets[d]].neighbors &= ~(1 << (DIR_COUNT - 1 - d));
+    }
+    node->neighbors = 0;
+}
+
+// Function to add a wall by removing edges and marking the grid
+void add_wall(Graph *graph, int x1, int y1, int x2, int y2, const int *offsets, MazeRng *rng, int GRID_SIZE)
+{
+    int passage_x = x1 + rng_below(rng, x2 - x1 + 1);
+    int passage_y = y1 + rng_below(rng, y2 - y1 + 1);
+    if (x1 == x2)
+    { // Vertical wall, contiguous in memory
+        for (int y = y1; y <= y2; y++)
+        {
+            if (y != passage_y) // Leave a passage
+                build_wall_cell(graph->nodes, x1 * GRID_SIZE + y, offsets);
+        }
+    }
+    else if (y1 == y2)
+    { // Horizontal wall
+        for (int x = x1; x <= x2; x++)
+        {
+            if (x != passage_x) // Leave a passage
+                build_wall_cell(graph->nodes, x * GRID_SIZE + y1, offsets);
+        }
+    }
+}
+// add random LETTERS to the graph
+void add_random_letters(Graph *graph, MazeRng *rng, int GRID_SIZE)
+{
+    for (int i = 0; i < GRID_SIZE; i++)
+    {
+        for (int j = 0; j < GRID_SIZE; j++)
+        {
+            Node *node = &graph->nodes[i * GRID_SIZE + j];
+            if (node->letter == ' ')
+            {
+                node->letter = 'A' + rng_below(rng, 26);
+            }
+        }
+    }
+}
+
+// A section of the grid still to divide
+typedef struct
+{
+    int startX, startY, endX, endY;
+} DivideSection;
+
+// Divide the graph into sections using walls, down to rooms of room_size cells across (2 gives the
+// narrow corridors of the game). Sections wait on an explicit stack instead of the native one: the
+// left or top section of a division is taken first, so the random draws, and the maze of a seed, are
+// those of dividing it recursively. A section on the stack is the second half of a division along
+// the current chain, and each division makes a section at least 2 cells narrower, so the stack never
+// holds more than GRID_SIZE sections.
+void divide_rooms(Graph *graph, int startX, int startY, int endX, int endY, int room_size, MazeRng *rng, int GRID_SIZE)
+{
+    DivideSection *stack = (DivideSection *)malloc(((size_t)GRID_SIZE + 1) * sizeof(DivideSection));
+    if (!stack)
+    {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    int offsets[DIR_COUNT];
+    for (int d = 0; d < DIR_COUNT; d++)
+        offsets[d] = DIR_DX[d] * GRID_SIZE + DIR_DY[d];
+
+    int top = 0;
+    stack[top++] = (DivideSection){startX, startY, endX, endY};
+    while (top > 0)
+    {
+        DivideSection section = stack[--top];
+        if (section.endX - section.startX < room_size || section.endY - section.startY < room_size)
+            continue; // Stop when sections are too small
+
+        DivideSection first = section, second = section;
+        if (rng_below(rng, 2) == 0)
+        { // Vertical division
+            int divideX = section.startX + rng_below(rng, section.endX - section.startX - 1) + 1;
+            add_wall(graph, divideX, section.startY, divideX, section.endY, offsets, rng, GRID_SIZE);
+            first.endX = divideX - 1;    // Left section
+            second.startX = divideX + 1; // Right section
+        }
+        else
+        { // Horizontal division
+            int divideY = section.startY + rng_below(rng, section.endY - section.startY - 1) + 1;
+            add_wall(graph, section.startX, divideY, section.endX, divideY, offsets, rng, GRID_SIZE);
+            first.endY = divideY - 1;    // Top section
+            second.startY = divideY + 1; // Bottom section
+        }
+        stack[top++] = second;
+        stack[top++] = first;
+    }
+    free(stack);
+}
+
+// Divide the graph into the corridors of the game
+void divide_graph(Graph *graph, int startX, int startY, int endX, int endY, MazeRng *rng, int GRID_SIZE)
+{
+    divide_rooms(graph, startX, startY, endX, endY, 2, rng, GRID_SIZE);
+}
+
+// Swap two entries of the priority queue
+void swap_entries(PriorityQueue *pq, int i, int j)
+{
+    Node *node = pq->nodes[i];
+    int distance = pq->distances[i];
+    pq->nodes[i] = pq->nodes[j];
+    pq->distances[i] = pq->distances[j];
+    pq->nodes[j] = node;
+    pq->distances[j] = distance;
+}
+
+// Function to push a node into the priority queue
+void push(PriorityQueue *pq, Node *node, int distance)
+{
+    if (pq->size == pq->capacity)
+    {
+        int capacity = pq->capacity ? pq->capacity * 2 : 64;
+        Node **nodes = (Node **)realloc(pq->nodes, capacity * sizeof(Node *));
+        int *distances = (int *)realloc(pq->distances, capacity * sizeof(int));
+        if (!nodes || !distances)
+        {
+            printf("Memory allocation error for priority queue.\n");
+            exit(1);
+        }
+        pq->nodes = nodes;
+        pq->distances = distances;
+        pq->capacity = capacity;
+    }
+
+    int i = pq->size++;
+    pq->nodes[i] = node;
+    pq->distances[i] = distance;
+
+    // Sift up
+    while (i > 0 && pq->distances[(i - 1) / 2] > pq->distances[i])
+    {
+        swap_entries(pq, i, (i - 1) / 2);
+        i = (i - 1) / 2;
+    }
+}
+
+// Function to pop the node with the shortest distance (its distance is stored in *distance)
+Node *pop(PriorityQueue *pq, int *distance)
+{
+    if (pq->size == 0)
+        return NULL;
+
+    Node *minNode = pq->nodes[0];
+    *distance = pq->distances[0];
+
+    // Move the last entry to the root and sift it down
+    pq->size--;
+    pq->nodes[0] = pq->nodes[pq->size];
+    pq->distances[0] = pq->distances[pq->size];
+
+    int i = 0;
+    while (1)
+    {
+        int smallest = i;
+        int left = 2 * i + 1;
+        int right = 2 * i + 2;
+        if (left < pq->size && pq->distances[left] < pq->distances[smallest])
+            smallest = left;
+        if (right < pq->size && pq->distances[right] < pq->distances[smallest])
+            smallest = right;
+        if (smallest == i)
+            break;
+        swap_entries(pq, i, smallest);
+        i = smallest;
+    }
+
+    return minNode;
+}
+
+// Release the priority queue storage
+void free_queue(PriorityQueue *pq)
+{
+    free(pq->nodes);
+    free(pq->distances);
+    pq->nodes = NULL;
+    pq->distances = NULL;
+    pq->size = 0;
+    pq->capacity = 0;
+}
+
+char *enlever_premier_dernier(const char *source)
+{
+    int longueur = strlen(source);
+
+    // Vérifier si la chaîne est trop courte pour être traitée
+    if (longueur <= 2)
+    {
+        return (char *)calloc(1, 1); // Retourner une chaîne vide
+    }
+
+    // Allouer une nouvelle chaîne de longueur -2 (+1 pour '\0')
+    char *nouvelle_chaine = (char *)malloc((longueur - 1) * sizeof(char));
+    if (!nouvelle_chaine)
+    {
+        return NULL; // Retourner NULL en cas d'échec d'allocation
+    }
+
+    strncpy(nouvelle_chaine, source + 1, longueur - 2);
+    nouvelle_chaine[longueur - 2] = '\0'; // Assurer la terminaison
+
+    return nouvelle_chaine;
+}
+
+// Rebuild the letters of a shortest path from its distance field, walking back from the end
+// to the first neighbor (in direction order) that is one step closer to the start. The path
+// only depends on the distances, not on the order the solver settled the nodes in.
+// The field stores distance + offset (offset 1 lets 0 mean "not reached" in a calloc'd field).
+char *trace_path(Graph *graph, const int *distances, int offset, Node *end, int GRID_SIZE)
+{
+    int path_length = distances[end->x * GRID_SIZE + end->y] - offset + 1;
+
+    // Create a string from collected letters
+    char *word = malloc(path_length + 1);
+    if (!word)
+    {
+        printf("Memory allocation failed.\n");
+        return NULL;
+    }
+
+    Node *at = end;
+    for (int i = path_length - 1; i >= 0; i--)
+    {
+        word[i] = at->letter; // Filled in reverse order
+        if (i == 0)
+            break;
+
+        for (int d = 0; d < DIR_COUNT; d++)
+        {
+            if (!(at->neighbors & (1 << d)))
+                continue;
+
+            Node *neighbor = get_neighbor(graph, at, d, GRID_SIZE);
+            if (distances[neighbor->x * GRID_SIZE + neighbor->y] == i - 1 + offset)
+            {
+                at = neighbor;
+                break;
+            }
+        }
+    }
+    word[path_length] = '\0';
+    // printf("Final Path: %s\n", word);
+    return word;
+}
+
+// Allocate a distance field with every node at INF
+int *new_distances(Graph *graph)
+{
+    int *distances = (int *)malloc(graph->node_count * sizeof(int));
+    if (!distances)
+    {
+        printf("Memory allocation failed.\n");
+        return NULL;
+    }
+
+    for (int i = 0; i < graph->node_count; i++)
+    {
+        distances[i] = INF;
+    }
+    return distances;
+}
+
+// Build the result of an engine from its distance field, and release the field
+char *finish_path(Graph *graph, int *distances, Node *start, Node *end, int GRID_SIZE)
+{
+    // If no path was found (start == end has no path either)
+    if (end == start || distances[end->x * GRID_SIZE + end->y] == INF)
+    {
+        // printf("No path found between (%d, %d) and (%d, %d).\n", start->x, start->y, end->x, end->y);
+        free(distances);
+        return NULL;
+    }
+
+    char *word = trace_path(graph, distances, 0, end, GRID_SIZE);
+    free(distances);
+    return word;
+}
+
+// Dijkstra engine
+char *find_shortest_path_dijkstra(Graph *graph, Node *start, Node *end, int GRID_SIZE)
+{
+    int *distances = new_distances(graph);
+    if (!distances)
+        return NULL;
+
+    // printf("Graph node count: %d\n", graph->node_count);
+
+    // printf("Start Node: (%d, %d) with letter '%c'\n", start->x, start->y, start->letter);
+    // printf("End Node: (%d, %d) with letter '%c'\n", end->x, end->y, end->letter);
+
+    distances[start->x * GRID_SIZE + start->y] = 0;
+
+    PriorityQueue pq = {0};
+    push(&pq, start, 0);
+
+    while (pq.size > 0)
+    {
+        int distance;
+        Node *current = pop(&pq, &distance);
+        int currentIndex = current->x * GRID_SIZE + current->y;
+
+        // Skip entries left behind when a shorter distance was found (lazy deletion)
+        if (distance > distances[currentIndex])
+            continue;
+        if (current == end)
+            break;
+
+        solver_expansions++;
+        // printf("Processing Node: (%d, %d) with letter '%c'\n", current->x, current->y, current->letter);
+
+        for (int d = 0; d < DIR_COUNT; d++)
+        {
+            if (!(current->neighbors & (1 << d)))
+                continue;
+
+            Node *neighbor = get_neighbor(graph, current, d, GRID_SIZE);
+
+            // Skip walls
+            if (neighbor->letter == '#')
+            {
+                // printf("Skipping wall at (%d, %d)\n", neighbor->x, neighbor->y);
+                continue;
+            }
+
+            int neighborIndex = neighbor->x * GRID_SIZE + neighbor->y;
+            int alt = distances[currentIndex] + 1;
+
+            // printf("Evaluating Neighbor: (%d, %d) with letter '%c'\n", neighbor->x, neighbor->y, neighbor->letter);
+            // printf("Current Distance: %d, New Distance: %d\n", distances[neighborIndex], alt);
+
+            if (alt < distances[neighborIndex])
+            {
+                distances[neighborIndex] = alt;
+                push(&pq, neighbor, alt);
+            }
+        }
+    }
+    free_queue(&pq);
+
+    return finish_path(graph, distances, start, end, GRID_SIZE);
+}
+
+// Breadth-first distances from a source node index, INF when unreachable. Nodes are
+// discovered in distance order, so with a target index (not -1) the search stops as soon as it
+// is reached: every node closer to the source then has its final distance, which is all
+// trace_path looks at. queue needs room for node_count entries (each node is queued once).
+void bfs_distances(Graph *graph, int source, int target, int *distances, int *queue, int GRID_SIZE)
+{
+    for (int i = 0; i < graph->node_count; i++)
+    {
+        distances[i] = INF;
+    }
+
+    int head = 0, tail = 0;
+    distances[source] = 0;
+    queue[tail++] = source;
+
+    while (head < tail && (target < 0 || distances[target] == INF))
+    {
+        Node *current = &graph->nodes[queue[head++]];
+        int currentIndex = current - graph->nodes;
+        solver_expansions++;
+
+        for (int d = 0; d < DIR_COUNT; d++)
+        {
+            if (!(current->neighbors & (1 << d)))
+                continue;
+
+            Node *neighbor = get_neighbor(graph, current, d, GRID_SIZE);
+            int neighborIndex = neighbor - graph->nodes;
+            if (neighbor->letter == '#' || distances[neighborIndex] != INF)
+                continue;
+
+            distances[neighborIndex] = distances[currentIndex] + 1;
+            queue[tail++] = neighborIndex;
+        }
+    }
+}
+
+// Breadth-first engine
+char *find_shortest_path_bfs(Graph *graph, Node *start, Node *end, int GRID_SIZE)
+{
+    int *distances = (int *)malloc(graph->node_count * sizeof(int));
+    int *queue = (int *)malloc(graph->node_count * sizeof(int));
+    if (!distances || !queue)
+    {
+        printf("Memory allocation failed.\n");
+        free(distances);
+        free(queue);
+        return NULL;
+    }
+
+    bfs_distances(graph, start - graph->nodes, end - graph->nodes, distances, queue, GRID_SIZE);
+    free(queue);
+
+    return finish_path(graph, distances, start, end, GRID_SIZE);
+}
+
+// Expand one whole layer of a breadth-first search: queue[*head..*tail) holds the nodes of the
+// current layer. The fields store distance + 1, so 0 means not reached. Returns the length of
+// the shortest path through a newly reached node that the other search (other) has already
+// reached, or INF.
+int bfs_expand_layer(Graph *graph, int *queue, int *head, int *tail, int *reached, const int *other, int GRID_SIZE)
+{
+    int best = INF;
+    int layer_end = *tail;
+    while (*head < layer_end)
+    {
+        Node *current = &graph->nodes[queue[(*head)++]];
+        int currentIndex = current - graph->nodes;
+        solver_expansions++;
+
+        for (int d = 0; d < DIR_COUNT; d++)
+        {
+            if (!(current->neighbors & (1 << d)))
+                continue;
+
+            Node *neighbor = get_neighbor(graph, current, d, GRID_SIZE);
+            int neighborIndex = neighbor - graph->nodes;
+            if (neighbor->letter == '#' || reached[neighborIndex])
+                continue;
+
+            reached[neighborIndex] = reached[currentIndex] + 1;
+            queue[(*tail)++] = neighborIndex;
+            if (other[neighborIndex] && reached[neighborIndex] + other[neighborIndex] - 2 < best)
+                best = reached[neighborIndex] + other[neighborIndex] - 2;
+        }
+    }
+    return best;
+}
+
+// Scratch memory of the bidirectional engine. Clearing whole fields would cost as much as a
+// one-sided search on big grids, so it is kept between queries, grown with the grid, and only the
+// entries listed in the queues are cleared after each query. Each thread has its own (see
+// free_solver_scratch).
+typedef struct
+{
+    int capacity;        // Cells
+    int *forward;        // Distance from the start + 1, 0 when not reached
+    int *backward;       // Distance from the end + 1, 0 when not reached
+    int *forward_queue;  // Every node reached from the start, in distance order
+    int *backward_queue; // Every node reached from the end, in distance order
+} BidirectionalScratch;
+
+_Thread_local BidirectionalScratch bidirectional_scratch = {0};
+
+// Make room for node_count cells, all unreached. Returns false if the memory is missing.
+bool reserve_bidirectional_scratch(BidirectionalScratch *scratch, int node_count)
+{
+    if (scratch->capacity >= node_count)
+        return true;
+
+    free(scratch->forward);
+    free(scratch->backward);
+    free(scratch->forward_queue);
+    free(scratch->backward_queue);
+    scratch->forward = (int *)calloc(node_count, sizeof(int));
+    scratch->backward = (int *)calloc(node_count, sizeof(int));
+    scratch->forward_queue = (int *)malloc(node_count * sizeof(int));
+    scratch->backward_queue = (int *)malloc(node_count * sizeof(int));
+    scratch->capacity = node_count;
+    if (!scratch->forward || !scratch->backward || !scratch->forward_queue || !scratch->backward_queue)
+    {
+        free(scratch->forward);
+        free(scratch->backward);
+        free(scratch->forward_queue);
+        free(scratch->backward_queue);
+        *scratch = (BidirectionalScratch){0};
+        return false;
+    }
+    return true;
+}
+
+// Release the scratch memory the engines keep between queries on the calling thread (before the
+// thread ends, or to give the memory back after a big grid)
+void free_solver_scratch(void)
+{
+    free(bidirectional_scratch.forward);
+    free(bidirectional_scratch.backward);
+    free(bidirectional_scratch.forward_queue);
+    free(bidirectional_scratch.backward_queue);
+    bidirectional_scratch = (BidirectionalScratch){0};
+}
+
+// Bidirectional breadth-first engine: one search from each end, growing the smaller frontier a
+// whole layer at a time, until a layer reaches a node the other search has reached. Each search
+// then knows every node up to its depth, and the two depths add up to at least the path length.
+// The nodes only reached from the end get their distance from the start (length minus distance
+// to the end) when they lie on a shortest path, so trace_path picks the same path as the other
+// engines. The cost only depends on the nodes reached, not on the grid size.
+char *find_shortest_path_bidirectional(Graph *graph, Node *start, Node *end, int GRID_SIZE)
+{
+    BidirectionalScratch *scratch = &bidirectional_scratch;
+    if (!reserve_bidirectional_scratch(scratch, graph->node_count))
+    {
+        printf("Memory allocation failed.\n");
+        return NULL;
+    }
+    int *forward = scratch->forward;
+    int *backward = scratch->backward;
+
+    int forward_head = 0, forward_tail = 0, backward_head = 0, backward_tail = 0;
+    forward[start - graph->nodes] = 1;
+    backward[end - graph->nodes] = 1;
+    scratch->forward_queue[forward_tail++] = start - graph->nodes;
+    scratch->backward_queue[backward_tail++] = end - graph->nodes;
+
+    int length = INF;
+    while (start != end && length == INF && forward_head < forward_tail && backward_head < backward_tail)
+    {
+        if (forward_tail - forward_head <= backward_tail - backward_head)
+            length = bfs_expand_layer(graph, scratch->forward_queue, &forward_head, &forward_tail, forward, backward, GRID_SIZE);
+        else
+            length = bfs_expand_layer(graph, scratch->backward_queue, &backward_head, &backward_tail, backward, forward, GRID_SIZE);
+    }
+
+    // Walk the backward search from its deepest layer: a node is on a shortest path if its
+    // distance from the start is known and matches, or if a neighbor one step further from the end
+    // is on a shortest path
+    for (int k = backward_tail - 1; k >= 0 && length != INF; k--)
+    {
+        int index = scratch->backward_queue[k];
+        if (forward[index])
+            continue;
+
+        Node *node = &graph->nodes[index];
+        for (int d = 0; d < DIR_COUNT; d++)
+        {
+            if (!(node->neighbors & (1 << d)))
+                continue;
+
+            int neighborIndex = get_neighbor(graph, node, d, GRID_SIZE) - graph->nodes;
+            if (backward[neighborIndex] == backward[index] + 1 && forward[neighborIndex] == length - backward[index] + 1)
+            {
+                forward[index] = length - backward[index] + 2;
+                break;
+            }
+        }
+    }
+
+    char *word = length == INF ? NULL : trace_path(graph, forward, 1, end, GRID_SIZE);
+
+    // Leave the scratch unreached for the next query
+    for (int k = 0; k < forward_tail; k++)
+        forward[scratch->forward_queue[k]] = 0;
+    for (int k = 0; k < backward_tail; k++)
+    {
+        forward[scratch->backward_queue[k]] = 0;
+        backward[scratch->backward_queue[k]] = 0;
+    }
+    return word;
+}
+
+// Heuristic of the A* engine: with diagonal steps costing 1, the octile distance is the
+// Chebyshev distance, which never overestimates and is consistent
+int chebyshev_distance(Node *a, Node *b)
+{
+    int dx = abs(a->x - b->x);
+    int dy = abs(a->y - b->y);
+    return dx > dy ? dx : dy;
+}
+
+// A* engine. The search does not stop when the end is popped: it also expands the nodes whose
+// estimate equals the path length, so every node on some shortest path gets its final distance
+// and trace_path picks the same path as the other engines.
+char *find_shortest_path_astar(Graph *graph, Node *start, Node *end, int GRID_SIZE)
+{
+    int *distances = new_distances(graph);
+    if (!distances)
+        return NULL;
+
+    int endIndex = end->x * GRID_SIZE + end->y;
+    distances[start->x * GRID_SIZE + start->y] = 0;
+
+    PriorityQueue pq = {0};
+    push(&pq, start, chebyshev_distance(start, end));
+
+    while (pq.size > 0)
+    {
+        int estimate;
+        Node *current = pop(&pq, &estimate);
+        int currentIndex = current - graph->nodes;
+
+        // Every remaining estimate is longer than the path found
+        if (estimate > distances[endIndex])
+            break;
+        // Skip entries left behind when a shorter distance was found (lazy deletion)
+        if (estimate > distances[currentIndex] + chebyshev_distance(current, end))
+            continue;
+        if (current == end)
+            continue;
+
+        solver_expansions++;
+        for (int d = 0; d < DIR_COUNT; d++)
+        {
+            if (!(current->neighbors & (1 << d)))
+                continue;
+
+            Node *neighbor = get_neighbor(graph, current, d, GRID_SIZE);
+            if (neighbor->letter == '#')
+                continue;
+
+            int neighborIndex = neighbor - graph->nodes;
+            int alt = distances[currentIndex] + 1;
+            if (alt < distances[neighborIndex])
+            {
+                distances[neighborIndex] = alt;
+                push(&pq, neighbor, alt + chebyshev_distance(neighbor, end));
+            }
+        }
+    }
+    free_queue(&pq);
+
+    return finish_path(graph, distances, start, end, GRID_SIZE);
+}
+
+// Bit-parallel BFS. Every grid row is a row of bits, so one BFS layer over the whole grid is a
+// few shifts, ORs and ANDs per 64 cells (or 128/256 cells per vector step). It relies on every
+// open cell being connected to all of its open neighbors, which is what initialize_graph and
+// add_wall produce. The board is built once per maze and can be reused for many queries.
+struct Bitboard
+{
+    int grid_size;
+    int words;          // 64-bit words per grid row
+    int stride;         // Words per stored row: one zero padding word on each side
+    uint64_t *open;     // Cells that are not walls
+    uint64_t *visited;  // Cells that already have a distance
+    uint64_t *frontier; // Cells of the current layer
+    uint64_t *next;     // Cells of the next layer
+    uint64_t *dilated;  // Frontier spread to the left and right neighbors
+    int *spans;         // Per row: first and last word holding frontier / next layer bits
+    int *rows;          // Rows holding frontier / next layer bits, and the layer each row was expanded in
+};
+
+// Start of grid row x in one of the planes (rows -1 and grid_size are zero padding)
+uint64_t *bitboard_row(Bitboard *board, uint64_t *plane, int x)
+{
+    return plane + (size_t)(x + 1) * board->stride + 1;
+}
+
+Bitboard *create_bitboard(Graph *graph, int GRID_SIZE)
+{
+    Bitboard *board = (Bitboard *)malloc(sizeof(Bitboard));
+    if (!board)
+    {
+        printf("Memory allocation failed.\n");
+        return NULL;
+    }
+    board->grid_size = GRID_SIZE;
+    board->words = (GRID_SIZE + 63) / 64;
+    board->stride = board->words + 2;
+
+    size_t plane = (size_t)(GRID_SIZE + 2) * board->stride;
+    uint64_t *planes = (uint64_t *)calloc(5 * plane, sizeof(uint64_t));
+    if (!planes)
+    {
+        printf("Memory allocation failed.\n");
+        free(board);
+        return NULL;
+    }
+    board->open = planes;
+    board->visited = planes + plane;
+    board->frontier = planes + 2 * plane;
+    board->next = planes + 3 * plane;
+    board->dilated = planes + 4 * plane;
+
+    // Padding rows included: frontier first/last, next first/last, then the row lists
+    board->spans = (int *)malloc((size_t)(GRID_SIZE + 2) * 7 * sizeof(int));
+    if (!board->spans)
+    {
+        printf("Memory allocation failed.\n");
+        free(planes);
+        free(board);
+        return NULL;
+    }
+    board->rows = board->spans + (size_t)(GRID_SIZE + 2) * 4;
+
+    for (int x = 0; x < GRID_SIZE; x++)
+    {
+        uint64_t *row = bitboard_row(board, board->open, x);
+        for (int y = 0; y < GRID_SIZE; y++)
+        {
+            if (graph->nodes[x * GRID_SIZE + y].letter != '#')
+                row[y / 64] |= 1ULL << (y % 64);
+        }
+    }
+    return board;
+}
+
+void free_bitboard(Bitboard *board)
+{
+    if (!board)
+        return;
+    free(board->open); // All the planes share one allocation
+    free(board->spans); // Shared with the row lists
+    free(board);
+}
+
+// dilated = frontier | frontier moved one cell left | frontier moved one cell right
+void bitboard_dilate_row(uint64_t *dilated, const uint64_t *frontier, int words)
+{
+    int w = 0;
+#if defined(__AVX2__)
+    for (; w + 4 <= words; w += 4)
+    {
+        __m256i mid = _mm256_loadu_si256((const __m256i *)(frontier + w));
+        __m256i left = _mm256_loadu_si256((const __m256i *)(frontier + w - 1));
+        __m256i right = _mm256_loadu_si256((const __m256i *)(frontier + w + 1));
+        __m256i spread = _mm256_or_si256(mid, _mm256_or_si256(_mm256_slli_epi64(mid, 1), _mm256_srli_epi64(mid, 1)));
+        spread = _mm256_or_si256(spread, _mm256_or_si256(_mm256_srli_epi64(left, 63), _mm256_slli_epi64(right, 63)));
+        _mm256_storeu_si256((__m256i *)(dilated + w), spread);
+    }
+#elif defined(__SSE2__)
+    for (; w + 2 <= words; w += 2)
+    {
+        __m128i mid = _mm_loadu_si128((const __m128i *)(frontier + w));
+        __m128i left = _mm_loadu_si128((const __m128i *)(frontier + w - 1));
+        __m128i right = _mm_loadu_si128((const __m128i *)(frontier + w + 1));
+        __m128i spread = _mm_or_si128(mid, _mm_or_si128(_mm_slli_epi64(mid, 1), _mm_srli_epi64(mid, 1)));
+        spread = _mm_or_si128(spread, _mm_or_si128(_mm_srli_epi64(left, 63), _mm_slli_epi64(right, 63)));
+        _mm_storeu_si128((__m128i *)(dilated + w), spread);
+    }
+#endif
+    for (; w < words; w++)
+    {
+        uint64_t mid = frontier[w];
+        dilated[w] = mid | (mid << 1) | (mid >> 1) | (frontier[w - 1] >> 63) | (frontier[w + 1] << 63);
+    }
+}
+
+// next = (up | mid | down) & open & ~visited, then visited |= next. Returns 0 if next is empty.
+int bitboard_expand_row(uint64_t *next, const uint64_t *up, const uint64_t *mid, const uint64_t *down,
+                        const uint64_t *open, uint64_t *visited, int words)
+{
+    uint64_t any = 0;
+    int w = 0;
+#if defined(__AVX2__)
+    __m256i any_vector = _mm256_setzero_si256();
+    for (; w + 4 <= words; w += 4)
+    {
+        __m256i around = _mm256_or_si256(_mm256_loadu_si256((const __m256i *)(up + w)),
+                                         _mm256_or_si256(_mm256_loadu_si256((const __m256i *)(mid + w)),
+                                                         _mm256_loadu_si256((const __m256i *)(down + w))));
+        __m256i seen = _mm256_loadu_si256((const __m256i *)(visited + w));
+        __m256i reached = _mm256_andnot_si256(seen, _mm256_and_si256(around, _mm256_loadu_si256((const __m256i *)(open + w))));
+        _mm256_storeu_si256((__m256i *)(next + w), reached);
+        _mm256_storeu_si256((__m256i *)(visited + w), _mm256_or_si256(seen, reached));
+        any_vector = _mm256_or_si256(any_vector, reached);
+    }
+    any = !_mm256_testz_si256(any_vector, any_vector);
+#elif defined(__SSE2__)
+    __m128i any_vector = _mm_setzero_si128();
+    for (; w + 2 <= words; w += 2)
+    {
+        __m128i around = _mm_or_si128(_mm_loadu_si128((const __m128i *)(up + w)),
+                                      _mm_or_si128(_mm_loadu_si128((const __m128i *)(mid + w)),
+                                                   _mm_loadu_si128((const __m128i *)(down + w))));
+        __m128i seen = _mm_loadu_si128((const __m128i *)(visited + w));
+        __m128i reached = _mm_andnot_si128(seen, _mm_and_si128(around, _mm_loadu_si128((const __m128i *)(open + w))));
+        _mm_storeu_si128((__m128i *)(next + w), reached);
+        _mm_storeu_si128((__m128i *)(visited + w), _mm_or_si128(seen, reached));
+        any_vector = _mm_or_si128(any_vector, reached);
+    }
+    any = _mm_movemask_epi8(_mm_cmpeq_epi8(any_vector, _mm_setzero_si128())) != 0xFFFF;
+#endif
+    for (; w < words; w++)
+    {
+        uint64_t reached = (up[w] | mid[w] | down[w]) & open[w] & ~visited[w];
+        next[w] = reached;
+        visited[w] |= reached;
+        any |= reached;
+    }
+    return any != 0;
+}
+
+// Fill distances (node_count entries) with the distance of every cell from the source node
+// index, INF for walls and unreachable cells. With a target index (not -1), the search stops
+// after the layer that reaches it: the distances up to that layer are final, the rest are INF.
+// Only the rows and words around the frontier are visited, so narrow corridors stay cheap
+// while open rooms are processed a vector at a time.
+void bitboard_distances(Bitboard *board, int source, int target, int *distances)
+{
+    int GRID_SIZE = board->grid_size;
+    int words = board->words;
+    size_t plane = (size_t)(GRID_SIZE + 2) * board->stride;
+    int *frontier_first = board->spans; // Indexed by row + 1 like the planes
+    int *frontier_last = frontier_first + GRID_SIZE + 2;
+    int *next_first = frontier_last + GRID_SIZE + 2;
+    int *next_last = next_first + GRID_SIZE + 2;
+    int *frontier_rows = board->rows;
+    int *next_rows = frontier_rows + GRID_SIZE + 2;
+    int *expanded_in = next_rows + GRID_SIZE + 2;
+
+    for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++)
+        distances[i] = INF;
+    memset(board->visited, 0, 3 * plane * sizeof(uint64_t)); // visited, frontier and next
+    for (int x = 0; x < GRID_SIZE + 2; x++)
+    {
+        frontier_first[x] = next_first[x] = words;
+        frontier_last[x] = next_last[x] = -1;
+        expanded_in[x] = 0;
+    }
+    distances[source] = 0;
+
+    int sx = source / GRID_SIZE, sy = source % GRID_SIZE;
+    if (!(bitboard_row(board, board->open, sx)[sy / 64] & (1ULL << (sy % 64))))
+        return; // A wall has no neighbors
+
+    bitboard_row(board, board->frontier, sx)[sy / 64] |= 1ULL << (sy % 64);
+    bitboard_row(board, board->visited, sx)[sy / 64] |= 1ULL << (sy % 64);
+    frontier_first[sx + 1] = frontier_last[sx + 1] = sy / 64;
+    frontier_rows[0] = sx;
+    int frontier_count = 1;
+
+    // Frontier and dilated words outside the spans of the listed rows are always zero
+    for (int distance = 1; frontier_count > 0 && (target < 0 || distances[target] == INF); distance++)
+    {
+        // Spread the frontier sideways, one word around the words that hold it
+        for (int i = 0; i < frontier_count; i++)
+        {
+            int x = frontier_rows[i];
+            int first = frontier_first[x + 1] - 1 > 0 ? frontier_first[x + 1] - 1 : 0;
+            int last = frontier_last[x + 1] + 1 < words - 1 ? frontier_last[x + 1] + 1 : words - 1;
+            bitboard_dilate_row(bitboard_row(board, board->dilated, x) + first,
+                                bitboard_row(board, board->frontier, x) + first, last - first + 1);
+        }
+
+        // Then up and down, keeping only the open cells seen for the first time
+        int next_count = 0;
+        for (int i = 0; i < frontier_count; i++)
+        {
+            for (int x = frontier_rows[i] - 1; x <= frontier_rows[i] + 1; x++)
+            {
+                if (x < 0 || x >= GRID_SIZE || expanded_in[x + 1] == distance)
+                    continue;
+                expanded_in[x + 1] = distance;
+
+                int first = words, last = -1;
+                for (int r = x; r <= x + 2; r++) // Rows x - 1 to x + 1, shifted by the padding row
+                {
+                    if (frontier_first[r] - 1 < first)
+                        first = frontier_first[r] - 1;
+                    if (frontier_last[r] + 1 > last)
+                        last = frontier_last[r] + 1;
+                }
+                first = first > 0 ? first : 0;
+                last = last < words - 1 ? last : words - 1;
+
+                uint64_t *next = bitboard_row(board, board->next, x);
+                if (!bitboard_expand_row(next + first, bitboard_row(board, board->dilated, x - 1) + first,
+                                         bitboard_row(board, board->dilated, x) + first,
+                                         bitboard_row(board, board->dilated, x + 1) + first,
+                                         bitboard_row(board, board->open, x) + first,
+                                         bitboard_row(board, board->visited, x) + first, last - first + 1))
+                {
+                    memset(next + first, 0, (last - first + 1) * sizeof(uint64_t));
+                    continue;
+                }
+
+                next_rows[next_count++] = x;
+                for (int w = first; w <= last; w++)
+                {
+                    if (!next[w])
+                        continue;
+                    if (w < next_first[x + 1])
+                        next_first[x + 1] = w;
+                    next_last[x + 1] = w;
+                    for (uint64_t bits = next[w]; bits; bits &= bits - 1)
+                        distances[x * GRID_SIZE + w * 64 + __builtin_ctzll(bits)] = distance;
+                }
+            }
+        }
+
+        // The next layer becomes the frontier, the old frontier and dilated words are cleared
+        for (int i = 0; i < frontier_count; i++)
+        {
+            int x = frontier_rows[i];
+            int first = frontier_first[x + 1] - 1 > 0 ? frontier_first[x + 1] - 1 : 0;
+            int last = frontier_last[x + 1] + 1 < words - 1 ? frontier_last[x + 1] + 1 : words - 1;
+            memset(bitboard_row(board, board->frontier, x) + first, 0, (last - first + 1) * sizeof(uint64_t));
+            memset(bitboard_row(board, board->dilated, x) + first, 0, (last - first + 1) * sizeof(uint64_t));
+            frontier_first[x + 1] = words;
+            frontier_last[x + 1] = -1;
+        }
+
+        uint64_t *frontier = board->frontier;
+        board->frontier = board->next;
+        board->next = frontier;
+        int *swap = frontier_first;
+        frontier_first = next_first;
+        next_first = swap;
+        swap = frontier_last;
+        frontier_last = next_last;
+        next_last = swap;
+        swap = frontier_rows;
+        frontier_rows = next_rows;
+        next_rows = swap;
+        frontier_count = next_count;
+    }
+}
+
+// Bitboard engine for a single query (batch users keep the board and call bitboard_distances)
+char *find_shortest_path_bitboard(Graph *graph, Node *start, Node *end, int GRID_SIZE)
+{
+    Bitboard *board = create_bitboard(graph, GRID_SIZE);
+    int *distances = (int *)malloc(graph->node_count * sizeof(int));
+    if (!board || !distances)
+    {
+        printf("Memory allocation failed.\n");
+        free_bitboard(board);
+        free(distances);
+        return NULL;
+    }
+
+    bitboard_distances(board, start - graph->nodes, end - graph->nodes, distances);
+    free_bitboard(board);
+
+    return finish_path(graph, distances, start, end, GRID_SIZE);
+}
+
+// Jump Point Search. Every open cell is linked to all of its open neighbors, diagonals included
+// even between two walls (add_wall only isolates the wall cells), so these are the forced
+// neighbor rules of JPS with corner cutting, with every step costing 1. Only the jump points go
+// through the priority queue; the straight and diagonal runs between them are scanned.
+bool has_edge(Node *node, int dx, int dy)
+{
+    return node->neighbors & (1 << get_direction(dx, dy));
+}
+
+int step_sign(int value)
+{
+    return (value > 0) - (value < 0);
+}
+
+// Neighbors of a node reached moving (dx, dy) that a path from the previous cell can only
+// reach through this node, because the cell beside it is a wall
+unsigned char jps_forced(Node *node, int dx, int dy)
+{
+    unsigned char forced = 0;
+    if (dx != 0 && dy != 0)
+    {
+        if (!has_edge(node, -dx, 0) && has_edge(node, -dx, dy))
+            forced |= 1 << get_direction(-dx, dy);
+        if (!has_edge(node, 0, -dy) && has_edge(node, dx, -dy))
+            forced |= 1 << get_direction(dx, -dy);
+    }
+    else
+    {
+        // Straight move: look at both sides, (dy, dx) and (-dy, -dx)
+        for (int side = -1; side <= 1; side += 2)
+        {
+            int sx = side * dy, sy = side * dx;
+            if (!has_edge(node, sx, sy) && has_edge(node, dx + sx, dy + sy))
+                forced |= 1 << get_direction(dx + sx, dy + sy);
+        }
+    }
+    return forced;
+}
+
+// Directions worth searching from a node reached moving (dx, dy)
+unsigned char jps_successors(Node *node, int dx, int dy)
+{
+    unsigned char natural = 1 << get_direction(dx, dy);
+    if (dx != 0 && dy != 0)
+        natural |= (1 << get_direction(dx, 0)) | (1 << get_direction(0, dy));
+    return (natural | jps_forced(node, dx, dy)) & node->neighbors;
+}
+
+// Run from node in direction (dx, dy) to the next jump point: the end, a node with a forced
+// neighbor, or on a diagonal run a node from which a straight run finds one. NULL at a dead end.
+Node *jps_jump(Graph *graph, Node *node, int dx, int dy, Node *end, int GRID_SIZE)
+{
+    int d = get_direction(dx, dy);
+    while (node->neighbors & (1 << d))
+    {
+        node = get_neighbor(graph, node, d, GRID_SIZE);
+        if (node == end || jps_forced(node, dx, dy))
+            return node;
+        if (dx != 0 && dy != 0 &&
+            (jps_jump(graph, node, dx, 0, end, GRID_SIZE) || jps_jump(graph, node, 0, dy, end, GRID_SIZE)))
+            return node;
+    }
+    return NULL;
+}
+
+// Letters of the path through the jump points, walking back from the end to each parent
+char *jps_trace_path(Graph *graph, const int *distances, const int *parents, Node *start, Node *end, int GRID_SIZE)
+{
+    int path_length = distances[end - graph->nodes] + 1;
+    char *word = malloc(path_length + 1);
+    if (!word)
+    {
+        printf("Memory allocation failed.\n");
+        return NULL;
+    }
+
+    int i = path_length - 1;
+    Node *at = end;
+    word[i] = at->letter;
+    while (at != start)
+    {
+        Node *jump_point = &graph->nodes[parents[at - graph->nodes]];
+        int d = get_direction(step_sign(jump_point->x - at->x), step_sign(jump_point->y - at->y));
+        while (at != jump_point)
+        {
+            at = get_neighbor(graph, at, d, GRID_SIZE);
+            word[--i] = at->letter;
+        }
+    }
+    word[path_length] = '\0';
+    return word;
+}
+
+// Jump Point Search engine: A* over the jump points. The path has the same length as the one of
+// the other engines, but it is not always the same path: the distances of the cells between jump
+// points are never known, so trace_path cannot be used.
+char *find_shortest_path_jps(Graph *graph, Node *start, Node *end, int GRID_SIZE)
+{
+    int *distances = new_distances(graph);
+    int *parents = (int *)malloc(graph->node_count * sizeof(int));
+    if (!distances || !parents)
+    {
+        printf("Memory allocation failed.\n");
+        free(distances);
+        free(parents);
+        return NULL;
+    }
+
+    int endIndex = end - graph->nodes;
+    distances[start - graph->nodes] = 0;
+
+    PriorityQueue pq = {0};
+    push(&pq, start, chebyshev_distance(start, end));
+
+    while (pq.size > 0)
+    {
+        int estimate;
+        Node *current = pop(&pq, &estimate);
+        int currentIndex = current - graph->nodes;
+
+        // Skip entries left behind when a shorter distance was found (lazy deletion)
+        if (estimate > distances[currentIndex] + chebyshev_distance(current, end))
+            continue;
+        if (current == end)
+            break;
+
+        solver_expansions++;
+        unsigned char successors = current->neighbors; // Every direction from the start
+        if (current != start)
+        {
+            Node *parent = &graph->nodes[parents[currentIndex]];
+            successors = jps_successors(current, step_sign(current->x - parent->x), step_sign(current->y - parent->y));
+        }
+
+        for (int d = 0; d < DIR_COUNT; d++)
+        {
+            if (!(successors & (1 << d)))
+                continue;
+
+            Node *jump_point = jps_jump(graph, current, DIR_DX[d], DIR_DY[d], end, GRID_SIZE);
+            if (!jump_point)
+                continue;
+
+            int jumpIndex = jump_point - graph->nodes;
+            int alt = distances[currentIndex] + chebyshev_distance(current, jump_point);
+            if (alt < distances[jumpIndex])
+            {
+                distances[jumpIndex] = alt;
+                parents[jumpIndex] = currentIndex;
+                push(&pq, jump_point, alt + chebyshev_distance(jump_point, end));
+            }
+        }
+    }
+    free_queue(&pq);
+
+    char *word = NULL;
+    if (end != start && distances[endIndex] != INF)
+        word = jps_trace_path(graph, distances, parents, start, end, GRID_SIZE);
+    free(distances);
+    free(parents);
+    return word;
+}
+
+// Engine from its name on the command line, or -1 if unknown
+int parse_engine(const char *name)
+{
+    for (int e = 0; e < ENGINE_COUNT; e++)
+    {
+        if (strcmp(name, ENGINE_NAMES[e]) == 0)
+            return e;
+    }
+    return -1;
+}
+
+// Shortest path function that returns the path as a string, using the selected engine
+char *find_shortest_path(Graph *graph, Node *start, Node *end, int GRID_SIZE)
+{
+    switch (solver_engine)
+    {
+    case ENGINE_BFS:
+        return find_shortest_path_bfs(graph, start, end, GRID_SIZE);
+    case ENGINE_ASTAR:
+        return find_shortest_path_astar(graph, start, end, GRID_SIZE);
+    case ENGINE_BITBOARD:
+        return find_shortest_path_bitboard(graph, start, end, GRID_SIZE);
+    case ENGINE_JPS:
+        return find_shortest_path_jps(graph, start, end, GRID_SIZE);
+    case ENGINE_BIDIRECTIONAL:
+        return find_shortest_path_bidirectional(graph, start, end, GRID_SIZE);
+    default:
+        return find_shortest_path_dijkstra(graph, start, end, GRID_SIZE);
+    }
+}
+
+// Shortest distances between every pair of waypoints (start, word ends, end), computed with one
+// full BFS per waypoint. For each waypoint it also keeps, per cell, the direction of the previous
+// node on the path from that waypoint, so any path between two waypoints can be rebuilt without
+// searching again. That costs one byte per cell per waypoint.
+typedef struct
+{
+    int count;               // Number of waypoints
+    Node **waypoints;        // The waypoints themselves
+    int *distances;          // distances[i * count + j]: from waypoint i to waypoint j, INF if unreachable
+    unsigned char *previous; // previous[i * node_count + n]: direction from node n towards waypoint i
+} WaypointMatrix;
+
+#define NO_DIRECTION 0xFF
+
+void free_waypoint_matrix(WaypointMatrix *matrix)
+{
+    if (!matrix)
+        return;
+    free(matrix->waypoints);
+    free(matrix->distances);
+    free(matrix->previous);
+    free(matrix);
+}
+
+WaypointMatrix *create_waypoint_matrix(Graph *graph, Node **waypoints, int count, int GRID_SIZE)
+{
+    WaypointMatrix *matrix = (WaypointMatrix *)calloc(1, sizeof(WaypointMatrix));
+    int *distances = (int *)malloc(graph->node_count * sizeof(int));
+    int *queue = (int *)malloc(graph->node_count * sizeof(int));
+    if (matrix)
+    {
+        matrix->count = count;
+        matrix->waypoints = (Node **)malloc(count * sizeof(Node *));
+        matrix->distances = (int *)malloc((size_t)count * count * sizeof(int));
+        matrix->previous = (unsigned char *)malloc((size_t)count * graph->node_count);
+    }
+    if (!matrix || !matrix->waypoints || !matrix->distances || !matrix->previous || !distances || !queue)
+    {
+        printf("Memory allocation failed!\n");
+        free_waypoint_matrix(matrix);
+        free(distances);
+        free(queue);
+        return NULL;
+    }
+    memcpy(matrix->waypoints, waypoints, count * sizeof(Node *));
+
+    for (int i = 0; i < count; i++)
+    {
+        bfs_distances(graph, waypoints[i] - graph->nodes, -1, distances, queue, GRID_SIZE);
+
+        for (int j = 0; j < count; j++)
+        {
+            matrix->distances[i * count + j] = distances[waypoints[j] - graph->nodes];
+        }
+
+        // Same choice as trace_path: the first neighbor one step closer to the waypoint
+        unsigned char *previous = matrix->previous + (size_t)i * graph->node_count;
+        for (int n = 0; n < graph->node_count; n++)
+        {
+            previous[n] = NO_DIRECTION;
+            if (distances[n] == INF || distances[n] == 0)
+                continue;
+
+            Node *node = &graph->nodes[n];
+            for (int d = 0; d < DIR_COUNT; d++)
+            {
+                if ((node->neighbors & (1 << d)) && distances[n + DIR_DX[d] * GRID_SIZE + DIR_DY[d]] == distances[n] - 1)
+                {
+                    previous[n] = d;
+                    break;
+                }
+            }
+        }
+    }
+
+    free(distances);
+    free(queue);
+    return matrix;
+}
+
+// Letters of the shortest path between two waypoints, the same string find_shortest_path returns
+char *waypoint_path(Graph *graph, WaypointMatrix *matrix, int from, int to, int GRID_SIZE)
+{
+    Node *start = matrix->waypoints[from];
+    Node *end = matrix->waypoints[to];
+    int length = matrix->distances[from * matrix->count + to];
+
+    // No path found (start == end has no path either)
+    if (start == end || length == INF)
+        return NULL;
+
+    char *word = malloc(length + 2);
+    if (!word)
+    {
+        printf("Memory allocation failed.\n");
+        return NULL;
+    }
+
+    const unsigned char *previous = matrix->previous + (size_t)from * graph->node_count;
+    Node *at = end;
+    for (int i = length; i >= 0; i--)
+    {
+        word[i] = at->letter; // Filled in reverse order
+        if (i > 0)
+            at = get_neighbor(graph, at, previous[at - graph->nodes], GRID_SIZE);
+    }
+    word[length + 1] = '\0';
+    return word;
+}
+
+// Waypoints of the matrix built by find_best_path: the start, the start and end of each word, the end
+#define WORD_START_WAYPOINT(j) (1 + 2 * (j))
+#define WORD_END_WAYPOINT(j) (2 + 2 * (j))
+
+// Waypoints where a word is entered and left when read forwards (dir 0) or backwards (dir 1)
+#define WORD_ENTRY_WAYPOINT(j, dir) ((dir) ? WORD_END_WAYPOINT(j) : WORD_START_WAYPOINT(j))
+#define WORD_EXIT_WAYPOINT(j, dir) ((dir) ? WORD_START_WAYPOINT(j) : WORD_END_WAYPOINT(j))
+
+// Order to visit words (Greedy nearest neighbor on maze distances), each word read forwards
+void find_greedy_word_order(WaypointMatrix *matrix, int word_count, int *visit_order)
+{
+    int visited[word_count];
+    memset(visited, 0, sizeof(visited));
+
+    int current = 0; // Start waypoint
+    int order_index = 0;
+    visit_order[order_index++] = current;
+
+    for (int i = 0; i < word_count; i++)
+    {
+        int best_index = -1;
+        int min_distance = INT_MAX;
+
+        for (int j = 0; j < word_count; j++)
+        {
+            if (!visited[j])
+            {
+                int distance = matrix->distances[current * matrix->count + WORD_START_WAYPOINT(j)];
+
+                if (best_index == -1 || distance < min_distance)
+                {
+                    min_distance = distance;
+                    best_index = j;
+                }
+            }
+        }
+
+        visited[best_index] = 1;
+
+        // Visit word start position, then word end position
+        visit_order[order_index++] = WORD_START_WAYPOINT(best_index);
+        visit_order[order_index++] = WORD_END_WAYPOINT(best_index);
+
+        // Update current position
+        current = visit_order[order_index - 1];
+    }
+
+    // Add the end node at the end of the visit order
+    visit_order[order_index] = matrix->count - 1;
+}
+
+// Largest word count ordered exactly: the table holds 2^W * W * 2 costs, 8 MB for 16 words, so a
+// batch can run one per thread (it would be 160 MB for 20). Longer lists use the local search.
+#define HELD_KARP_MAX_WORDS 16
+
+// Exact order to visit words (Held-Karp dynamic programming over subsets of words). A word can be
+// read in either direction: cost[mask][j][dir] is the shortest walk from the start that covers
+// the words in mask and ends after reading word j forwards (dir 0) or backwards (dir 1).
+// Takes 2^W * W^2 * 4 steps: under 1 ms for 8 words, 10 ms for 12, 0.2 s for 16, 4 s for 20.
+// Returns 0 if some word cannot be reached (or the table does not fit in memory).
+int find_exact_word_order(WaypointMatrix *matrix, int word_count, int *visit_order)
+{
+    int count = matrix->count;
+    int end = count - 1;
+    size_t full = ((size_t)1 << word_count) - 1;
+    int *cost = (int *)malloc((full + 1) * word_count * 2 * sizeof(int));
+    int *inner = (int *)malloc(word_count * sizeof(int)); // Steps from one end of a word to the other
+    if (!cost || !inner)
+    {
+        free(cost);
+        free(inner);
+        return 0;
+    }
+#define COST(mask, j, dir) cost[((mask) * word_count + (j)) * 2 + (dir)]
+#define DISTANCE(a, b) matrix->distances[(a) * count + (b)]
+
+    for (size_t i = 0; i < (full + 1) * word_count * 2; i++)
+        cost[i] = INF;
+    for (int j = 0; j < word_count; j++)
+    {
+        inner[j] = DISTANCE(WORD_START_WAYPOINT(j), WORD_END_WAYPOINT(j));
+        for (int dir = 0; dir < 2; dir++)
+        {
+            if (inner[j] != INF && DISTANCE(0, WORD_ENTRY_WAYPOINT(j, dir)) != INF)
+                COST((size_t)1 << j, j, dir) = DISTANCE(0, WORD_ENTRY_WAYPOINT(j, dir)) + inner[j];
+        }
+    }
+
+    // Subsets grow in increasing order, so every subset is final before it is extended
+    for (size_t mask = 1; mask < full; mask++)
+    {
+        for (int j = 0; j < word_count; j++)
+        {
+            for (int dir = 0; dir < 2; dir++)
+            {
+                int current = COST(mask, j, dir);
+                if (current == INF)
+                    continue;
+
+                for (int k = 0; k < word_count; k++)
+                {
+                    if (mask & ((size_t)1 << k))
+                        continue;
+                    for (int e = 0; e < 2; e++)
+                    {
+                        int step = DISTANCE(WORD_EXIT_WAYPOINT(j, dir), WORD_ENTRY_WAYPOINT(k, e));
+                        if (step == INF || inner[k] == INF)
+                            continue;
+                        int next = current + step + inner[k];
+                        if (next < COST(mask | ((size_t)1 << k), k, e))
+                            COST(mask | ((size_t)1 << k), k, e) = next;
+                    }
+                }
+            }
+        }
+    }
+
+    // Best last word, counting the way to the end
+    int best = INF, last = -1, last_dir = 0;
+    for (int j = 0; j < word_count; j++)
+    {
+        for (int dir = 0; dir < 2; dir++)
+        {
+            if (COST(full, j, dir) == INF || DISTANCE(WORD_EXIT_WAYPOINT(j, dir), end) == INF)
+                continue;
+            if (COST(full, j, dir) + DISTANCE(WORD_EXIT_WAYPOINT(j, dir), end) < best)
+            {
+                best = COST(full, j, dir) + DISTANCE(WORD_EXIT_WAYPOINT(j, dir), end);
+                last = j;
+                last_dir = dir;
+            }
+        }
+    }
+    if (last < 0)
+    {
+        free(cost);
+        free(inner);
+        return 0;
+    }
+
+    // Walk the table back from the last word to the first
+    visit_order[0] = 0;
+    visit_order[count - 1] = end;
+    size_t mask = full;
+    for (int position = word_count - 1; position >= 0; position--)
+    {
+        visit_order[1 + 2 * position] = WORD_ENTRY_WAYPOINT(last, last_dir);
+        visit_order[2 + 2 * position] = WORD_EXIT_WAYPOINT(last, last_dir);
+        if (position == 0)
+            break;
+
+        size_t previous = mask & ~((size_t)1 << last);
+        int found = 0;
+        for (int k = 0; k < word_count && !found; k++)
+        {
+            for (int e = 0; e < 2 && !found; e++)
+            {
+                int step = (previous & ((size_t)1 << k)) ? DISTANCE(WORD_EXIT_WAYPOINT(k, e), WORD_ENTRY_WAYPOINT(last, last_dir)) : INF;
+                if (COST(previous, k, e) != INF && step != INF &&
+                    COST(previous, k, e) + step + inner[last] == COST(mask, last, last_dir))
+                {
+                    mask = previous;
+                    last = k;
+                    last_dir = e;
+                    found = 1;
+                }
+            }
+        }
+    }
+
+#undef COST
+#undef DISTANCE
+    free(cost);
+    free(inner);
+    return 1;
+}
+
+// Budget of the local search used for levels with more words than Held-Karp can handle
+#define WORD_ORDER_TIME_LIMIT 0.5  // Seconds
+#define WORD_ORDER_MAX_ROUNDS 2000 // Perturbation + local search rounds
+
+// Word route improved by the local search: position p reads word words[p] in direction dirs[p].
+// Positions -1 and count stand for the start and the end of the maze.
+typedef struct
+{
+    WaypointMatrix *matrix;
+    int count;
+    int *words;
+    int *dirs;
+    int *scratch; // Room for 2 * count entries while a move is applied
+} WordRoute;
+
+// Waypoint left at position p, and waypoint entered at position p
+int route_exit(WordRoute *route, int p)
+{
+    return p < 0 ? 0 : WORD_EXIT_WAYPOINT(route->words[p], route->dirs[p]);
+}
+
+int route_entry(WordRoute *route, int p)
+{
+    return p >= route->count ? route->matrix->count - 1 : WORD_ENTRY_WAYPOINT(route->words[p], route->dirs[p]);
+}
+
+long long route_distance(WordRoute *route, int a, int b)
+{
+    return route->matrix->distances[a * route->matrix->count + b]; // INF stays a (large) finite cost
+}
+
+// Steps between position p and position p + 1
+long long route_link(WordRoute *route, int p)
+{
+    return route_distance(route, route_exit(route, p), route_entry(route, p + 1));
+}
+
+// Length of the whole walk, the steps inside the words included
+long long route_cost(WordRoute *route)
+{
+    long long cost = 0;
+    for (int p = -1; p < route->count; p++)
+    {
+        cost += route_link(route, p);
+        if (p >= 0)
+            cost += route_distance(route, WORD_START_WAYPOINT(route->words[p]), WORD_END_WAYPOINT(route->words[p]));
+    }
+    return cost;
+}
+
+// Reverse positions i..j, each of those words then being read the other way
+void route_reverse(WordRoute *route, int i, int j)
+{
+    for (; i <= j; i++, j--)
+    {
+        int word = route->words[i];
+        int dir = route->dirs[i];
+        route->words[i] = route->words[j];
+        route->dirs[i] = !route->dirs[j];
+        route->words[j] = word;
+        route->dirs[j] = !dir;
+    }
+}
+
+// Move the length words starting at position i between positions p and p + 1 (p outside the
+// moved words), reversed or not
+void route_move(WordRoute *route, int i, int length, int p, int reversed)
+{
+    int *words = route->scratch;
+    int *dirs = route->scratch + route->count;
+    int n = 0;
+
+    for (int q = -1; q < route->count; q++)
+    {
+        if (q >= 0 && (q < i || q >= i + length))
+        {
+            words[n] = route->words[q];
+            dirs[n++] = route->dirs[q];
+        }
+        if (q == p)
+        {
+            for (int k = 0; k < length; k++)
+            {
+                int from = reversed ? i + length - 1 - k : i + k;
+                words[n] = route->words[from];
+                dirs[n++] = reversed ? !route->dirs[from] : route->dirs[from];
+            }
+        }
+    }
+    memcpy(route->words, words, route->count * sizeof(int));
+    memcpy(route->dirs, dirs, route->count * sizeof(int));
+}
+
+// Wall clock time in seconds. The time limits use it rather than clock(), which counts the CPU time
+// of every thread of the process.
+double wall_seconds(void)
+{
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+bool out_of_time(double begin, double time_limit)
+{
+    return wall_seconds() - begin > time_limit;
+}
+
+// 2-opt and direction flips (a flip is the reversal of a single word): only the two links around
+// the reversed positions change. Returns true if the route was improved.
+bool improve_by_reversal(WordRoute *route, double begin, double time_limit)
+{
+    bool improved = false;
+    for (int i = 0; i < route->count && !out_of_time(begin, time_limit); i++)
+    {
+        for (int j = i; j < route->count; j++)
+        {
+            long long before = route_link(route, i - 1) + route_link(route, j);
+            long long after = route_distance(route, route_exit(route, i - 1), WORD_EXIT_WAYPOINT(route->words[j], route->dirs[j])) +
+                              route_distance(route, WORD_ENTRY_WAYPOINT(route->words[i], route->dirs[i]), route_entry(route, j + 1));
+            if (after < before)
+            {
+                route_reverse(route, i, j);
+                improved = true;
+            }
+        }
+    }
+    return improved;
+}
+
+// Or-opt: move 1 to 3 consecutive words elsewhere in the route, possibly reversed.
+// Returns true if the route was improved.
+bool improve_by_moving(WordRoute *route, double begin, double time_limit)
+{
+    bool improved = false;
+    for (int length = 1; length <= 3; length++)
+    {
+        for (int i = 0; i + length <= route->count && !out_of_time(begin, time_limit); i++)
+        {
+            int last = i + length - 1;
+            long long removed = route_link(route, i - 1) + route_link(route, last) -
+                                route_distance(route, route_exit(route, i - 1), route_entry(route, last + 1));
+
+            bool moved = false; // These words found a better place, go on with the next ones
+            for (int p = -1; p < route->count && !moved; p++)
+            {
+                if (p >= i - 1 && p <= last)
+                    continue; // Same place, or inside the moved words
+
+                for (int reversed = 0; reversed < 2; reversed++)
+                {
+                    int first_entry = reversed ? route_exit(route, last) : route_entry(route, i);
+                    int last_exit = reversed ? route_entry(route, i) : route_exit(route, last);
+                    long long added = route_distance(route, route_exit(route, p), first_entry) +
+                                      route_distance(route, last_exit, route_entry(route, p + 1)) - route_link(route, p);
+                    if (added < removed)
+                    {
+                        route_move(route, i, length, p, reversed);
+                        moved = improved = true;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    return improved;
+}
+
+// Improve a visit order (as filled by find_greedy_word_order) with 2-opt, Or-opt and direction
+// flips until no move helps, then kick the route (swap two random stretches of words) and search
+// again, keeping the best route, until the time or round budget runs out. Returns the new length.
+// The kicks come from a fixed seed, so a maze always gets the same rounds.
+long long improve_word_order(WaypointMatrix *matrix, int word_count, int *visit_order, double time_limit, int max_rounds)
+{
+    WordRoute route = {matrix, word_count, NULL, NULL, NULL};
+    int *buffer = (int *)malloc(word_count * 6 * sizeof(int));
+    if (!buffer)
+    {
+        printf("Memory allocation failed!\n");
+        return -1;
+    }
+    route.words = buffer;
+    route.dirs = buffer + word_count;
+    route.scratch = buffer + 2 * word_count;
+    int *best_words = buffer + 4 * word_count;
+    int *best_dirs = buffer + 5 * word_count;
+
+    for (int p = 0; p < word_count; p++)
+    {
+        int entry = visit_order[1 + 2 * p];
+        route.words[p] = (entry - 1) / 2;
+        route.dirs[p] = entry == WORD_END_WAYPOINT(route.words[p]);
+    }
+
+    MazeRng rng;
+    seed_rng(&rng, word_count);
+
+    double begin = wall_seconds();
+    long long initial = route_cost(&route);
+    while ((improve_by_reversal(&route, begin, time_limit) | improve_by_moving(&route, begin, time_limit)) &&
+           !out_of_time(begin, time_limit))
+        ;
+    long long best = route_cost(&route);
+    memcpy(best_words, route.words, word_count * sizeof(int));
+    memcpy(best_dirs, route.dirs, word_count * sizeof(int));
+
+    for (int round = 0; round < max_rounds && word_count >= 4 && !out_of_time(begin, time_limit); round++)
+    {
+        // Double bridge: A B C D becomes A C B D, B being positions a..b-1 and C b..c-1
+        int a = rng_below(&rng, word_count - 2);
+        int b = a + 1 + rng_below(&rng, word_count - a - 2);
+        int c = b + 1 + rng_below(&rng, word_count - b);
+        route_move(&route, a, b - a, c - 1, 0);
+
+        while ((improve_by_reversal(&route, begin, time_limit) | improve_by_moving(&route, begin, time_limit)) &&
+               !out_of_time(begin, time_limit))
+            ;
+
+        long long cost = route_cost(&route);
+        if (cost < best)
+        {
+            best = cost;
+            memcpy(best_words, route.words, word_count * sizeof(int));
+            memcpy(best_dirs, route.dirs, word_count * sizeof(int));
+        }
+        else
+        {
+            memcpy(route.words, best_words, word_count * sizeof(int));
+            memcpy(route.dirs, best_dirs, word_count * sizeof(int));
+        }
+    }
+
+    for (int p = 0; p < word_count; p++)
+    {
+        visit_order[1 + 2 * p] = WORD_ENTRY_WAYPOINT(best_words[p], best_dirs[p]);
+        visit_order[2 + 2 * p] = WORD_EXIT_WAYPOINT(best_words[p], best_dirs[p]);
+    }
+    if (maze_verbose)
+        printf("Word order: %lld steps greedy, %lld after local search (%.1f%% shorter)\n", initial, best,
+               initial > 0 ? 100.0 * (initial - best) / initial : 0.0);
+
+    free(buffer);
+    return best;
+}
+
+// Find the optimal order to visit words: exact for up to HELD_KARP_MAX_WORDS words, and
+// greedy improved by local search beyond
+// visit_order receives the word_count * 2 + 2 waypoint indices to walk through, start and end included
+void find_best_word_order(WaypointMatrix *matrix, int word_count, int *visit_order)
+{
+    if (word_count > 0 && word_count <= HELD_KARP_MAX_WORDS && find_exact_word_order(matrix, word_count, visit_order))
+        return;
+
+    find_greedy_word_order(matrix, word_count, visit_order);
+    if (word_count > 1)
+        improve_word_order(matrix, word_count, visit_order, WORD_ORDER_TIME_LIMIT, WORD_ORDER_MAX_ROUNDS);
+}
+
+// Function to compute and print the full path (start → word start → word end → next word → end)
+char *concatenate_paths(char **segments, int count)
+{
+    int total_length = 0;
+
+    // Calculate total length needed
+    for (int i = 0; i < count; i++)
+    {
+        if (segments[i])
+        {
+            total_length += strlen(segments[i]);
+        }
+    }
+
+    // Allocate memory for final path
+    char *final_path = malloc(total_length + 1);
+    if (!final_path)
+        return NULL;
+
+    final_path[0] = '\0'; // Initialize as empty string
+
+    // Concatenate all segments
+    for (int i = 0; i < count; i++)
+    {
+        if (segments[i])
+        {
+            strcat(final_path, segments[i]);
+        }
+    }
+
+    return final_path;
+}
+
+char *find_best_path(Graph *graph, WordPosition *word_positions, int word_count, int GRID_SIZE)
+{
+    int waypoint_count = word_count * 2 + 2;
+    Node **waypoints = malloc(waypoint_count * sizeof(Node *));
+    int *visit_order = malloc(waypoint_count * sizeof(int));
+    if (!waypoints || !visit_order)
+    {
+        printf("Memory allocation failed!\n");
+        free(waypoints);
+        free(visit_order);
+        return NULL;
+    }
+
+    waypoints[0] = graph->start;
+    for (int j = 0; j < word_count; j++)
+    {
+        waypoints[WORD_START_WAYPOINT(j)] = &graph->nodes[word_positions[j].startX * GRID_SIZE + word_positions[j].startY];
+        waypoints[WORD_END_WAYPOINT(j)] = &graph->nodes[word_positions[j].endX * GRID_SIZE + word_positions[j].endY];
+    }
+    waypoints[waypoint_count - 1] = graph->end;
+
+    // One BFS per waypoint gives every distance and path needed below
+    WaypointMatrix *matrix = create_waypoint_matrix(graph, waypoints, waypoint_count, GRID_SIZE);
+    free(waypoints);
+    if (!matrix)
+    {
+        free(visit_order);
+        return NULL;
+    }
+
+    // Compute the best order to visit words
+    find_best_word_order(matrix, word_count, visit_order);
+
+    // Array to store path segments
+    char **path_segments = malloc((word_count * 2 + 1) * sizeof(char *));
+    if (!path_segments)
+    {
+        printf("Memory allocation failed!\n");
+        free_waypoint_matrix(matrix);
+        free(visit_order);
+        return NULL;
+    }
+
+    if (maze_verbose)
+        printf("\nOptimal Path:\n");
+    for (int i = 0; i < word_count * 2 + 1; i++)
+    {
+        path_segments[i] = waypoint_path(graph, matrix, visit_order[i], visit_order[i + 1], GRID_SIZE);
+
+        // Remove redundant start & end nodes from paths
+        if (i > 0)
+        {
+            char *prev_path = path_segments[i - 1];
+            char *curr_path = path_segments[i];
+
+            // Ensure we don’t repeat the last character of prev_path and first of curr_path
+            if (prev_path && curr_path)
+            {
+                int prev_len = strlen(prev_path);
+                int curr_len = strlen(curr_path);
+
+                // If last char of prev_path matches first char of curr_path, remove duplicate
+                if (prev_len > 0 && curr_len > 0 && prev_path[prev_len - 1] == curr_path[0])
+                {
+                    memmove(curr_path, curr_path + 1, curr_len); // Shift left to remove duplicate
+                }
+            }
+        }
+    }
+
+    // Concatenate all path segments into a single path
+    char *final_path = concatenate_paths(path_segments, word_count * 2 + 1);
+    if (final_path && maze_verbose)
+    {
+        printf("%s\n", final_path);
+    }
+
+    // Free allocated memory
+    for (int i = 0; i < word_count * 2 + 1; i++)
+    {
+        free(path_segments[i]);
+    }
+    free(path_segments);
+    free_waypoint_matrix(matrix);
+    free(visit_order);
+    return final_path;
+}
+
+// A word is found when its letters were collected in a row, read forwards or backwards
+// (find_best_path may read a word backwards when that makes the path shorter)
+bool path_contains_word(const char *path, const char *word)
+{
+    if (strstr(path, word))
+        return true;
+
+    int length = strlen(word);
+    char reversed[length + 1];
+    for (int i = 0; i < length; i++)
+    {
+        reversed[i] = word[length - 1 - i];
+    }
+    reversed[length] = '\0';
+    return strstr(path, reversed) != NULL;
+}
+
+void free_hint_fields(HintFields *hints)
+{
+    if (!hints)
+        return;
+
+    free(hints->to_end);
+    free(hints);
+}
+
+HintFields *create_hint_fields(Graph *graph, WordPosition *word_positions, int word_count, int GRID_SIZE)
+{
+    HintFields *hints = (HintFields *)malloc(sizeof(HintFields));
+    int *fields = (int *)malloc((size_t)(1 + 2 * word_count) * graph->node_count * sizeof(int));
+    int *queue = (int *)malloc(graph->node_count * sizeof(int));
+    if (!hints || !fields || !queue)
+    {
+        printf("Memory allocation failed.\n");
+        free(hints);
+        free(fields);
+        free(queue);
+        return NULL;
+    }
+
+    hints->node_count = graph->node_count;
+    hints->word_count = word_count;
+    hints->word_positions = word_positions;
+    hints->to_end = fields;
+    hints->to_words = fields + graph->node_count;
+
+    bfs_distances(graph, graph->end - graph->nodes, -1, hints->to_end, queue, GRID_SIZE);
+
+    // Reaching the end finishes the game, so the way to a word must not go through it: the end
+    // counts as a wall while the word fields are computed
+    char end_letter = graph->end->letter;
+    graph->end->letter = '#';
+    for (int j = 0; j < word_count; j++)
+    {
+        WordPosition *position = &word_positions[j];
+        bfs_distances(graph, position->startX * GRID_SIZE + position->startY, -1,
+                      hints->to_words + (size_t)(2 * j) * graph->node_count, queue, GRID_SIZE);
+        bfs_distances(graph, position->endX * GRID_SIZE + position->endY, -1,
+                      hints->to_words + (size_t)(2 * j + 1) * graph->node_count, queue, GRID_SIZE);
+    }
+    graph->end->letter = end_letter;
+    free(queue);
+    return hints;
+}
+
+// Direction of the next step suggested from the player's cell, or -1: on through the word the
+// player is collecting, else towards the closest end of a word not collected yet, else to the end
+int hint_direction(HintFields *hints, Graph *graph, Player *player, int GRID_SIZE)
+{
+    int cell = player->x * GRID_SIZE + player->y;
+    int path_length = strlen(player->path);
+    const int *target = hints->to_end;
+    int closest = INF;
+
+    for (int j = 0; j < hints->word_count; j++)
+    {
+        WordPosition *position = &hints->word_positions[j];
+        if (path_contains_word(player->path, position->word))
+            continue;
+
+        // On the word, with its letters up to this cell last in the path: keep going along it
+        int dx = position->direction ? 0 : 1;
+        int dy = position->direction ? 1 : 0;
+        int offset = (player->x - position->startX) + (player->y - position->startY);
+        bool on_word = (position->direction ? player->x == position->startX : player->y == position->startY) &&
+                       offset >= 0 && offset < position->length;
+        if (on_word)
+        {
+            int forward = offset + 1;               // word[0..offset], read from the start
+            int backward = position->length - offset; // word[length - 1..offset], read from the end
+            if (forward <= path_length && strncmp(player->path + path_length - forward, position->word, forward) == 0)
+                return get_direction(dx, dy);
+
+            bool reading_backward = backward <= path_length;
+            for (int i = 0; i < backward && reading_backward; i++)
+                reading_backward = player->path[path_length - backward + i] == position->word[position->length - 1 - i];
+            if (reading_backward)
+                return get_direction(-dx, -dy);
+        }
+
+        for (int k = 0; k < 2; k++)
+        {
+            const int *field = hints->to_words + (size_t)(2 * j + k) * hints->node_count;
+            if (field[cell] < closest)
+            {
+                closest = field[cell];
+                target = field;
+            }
+        }
+    }
+
+    // First neighbor one step closer to the target
+    if (target[cell] == INF || target[cell] == 0)
+        return -1;
+
+    Node *node = &graph->nodes[cell];
+    for (int d = 0; d < DIR_COUNT; d++)
+    {
+        if ((node->neighbors & (1 << d)) && target[get_neighbor(graph, node, d, GRID_SIZE) - graph->nodes] == target[cell] - 1)
+            return d;
+    }
+    return -1;
+}
+
+// calucl score
+int calculate_score(char *path, WordPosition *word_positions, int word_count, int best_path_length)
+{
+    int score = 0;
+    int all_words_found = 1; // Assume all words are found
+    for (int i = 0; i < word_count; i++)
+    {
+        const char *word = word_positions[i].word;
+        if (path_contains_word(path, word))
+        {
+            score += strlen(word) * 3;
+        }
+        else
+        {
+            all_words_found = 0; // If any word is not found, set this to 0
+        }
+    }
+
+    // If all words are found and the path length is the best path length, add 50 bonus points
+    if (all_words_found && (int)strlen(path) <= best_path_length)
+    {
+        score += 50;
+    }
+
+    return score;
+}
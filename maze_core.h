@@ -0,0 +1,174 @@
+#ifndef MAZE_CORE_H
+#define MAZE_CORE_H
+
+// Maze core: the graph, maze generation, word placement, solving, hints and scoring. It has no SDL
+// dependency and is built as libmaze_core.a, which the game and the headless tools link against.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <limits.h>
+#include <stdint.h>
+
+#define INF INT_MAX
+#define MAX_GRID_SIZE 4096 // Largest board the game plays and a maze file holds
+
+// Neighbor directions, row-major around the cell (the opposite of d is 7 - d)
+enum
+{
+    DIR_UP_LEFT,
+    DIR_UP,
+    DIR_UP_RIGHT,
+    DIR_LEFT,
+    DIR_RIGHT,
+    DIR_DOWN_LEFT,
+    DIR_DOWN,
+    DIR_DOWN_RIGHT,
+    DIR_COUNT
+};
+
+static const int DIR_DX[DIR_COUNT] = {-1, -1, -1, 0, 0, 1, 1, 1};
+static const int DIR_DY[DIR_COUNT] = {-1, 0, 1, -1, 1, -1, 0, 1};
+
+typedef struct Node
+{
+    int x, y;
+    unsigned char neighbors; // Bit d set when the edge towards DIR_DX[d], DIR_DY[d] is open
+    char letter;
+    bool visited;
+    bool is_part_of_word;
+} Node;
+
+typedef struct
+{
+    const char *word; // Le mot en question
+    int startX;       // Coordonnée X de départ
+    int startY;       // Coordonnée Y de départ
+    int endX;
+    int endY;
+    int direction; // 0 pour horizontal, 1 pour vertical
+    int length;    // Longueur du mot
+} WordPosition;
+
+// Everything a maze owns (its nodes, its word positions and the text of its words) lives in one
+// arena allocated with the graph: destroy_graph frees it all at once, and reset_graph reuses it
+// for the next maze. The space after the nodes is sized from the number of words the maze holds.
+#define GRAPH_WORD_LENGTH 20 // Longest word text planned for, terminator included (see load_words)
+#define GRAPH_WORD_BYTES(word_count) \
+    (((size_t)(word_count) + 1) * (sizeof(WordPosition) + GRAPH_WORD_LENGTH + 8)) // Padding included
+
+typedef struct
+{
+    Node *nodes; // GRID_SIZE * GRID_SIZE cells, row-major, at the start of the arena
+    int node_count;
+    Node *start;
+    Node *end;
+    size_t arena_size; // Bytes of the arena, which follows the Graph in the same allocation
+    size_t arena_used; // Bytes handed out, the nodes first
+} Graph;
+
+typedef struct
+{
+    int x, y;
+    int score;
+    char path[200]; // Path to store collected letters
+} Player;
+
+// Random number generator of one maze (xoshiro128**), passed to every generation step: the same
+// seed always gives the same maze, and mazes with their own generators can be built at the same time
+typedef struct
+{
+    uint32_t state[4];
+} MazeRng;
+
+// Shortest path engines, all return the same path (see trace_path) except JPS, which returns a
+// path of the same length
+typedef enum
+{
+    ENGINE_DIJKSTRA,      // General priority queue search
+    ENGINE_BFS,           // Breadth-first search, every edge costs 1
+    ENGINE_ASTAR,         // A* with the Chebyshev distance (diagonal steps cost 1)
+    ENGINE_BITBOARD,      // Bit-parallel breadth-first search over the wall bitmask
+    ENGINE_JPS,           // Jump Point Search, fast in open rooms
+    ENGINE_BIDIRECTIONAL, // Breadth-first search from both ends, for distant cells
+    ENGINE_COUNT
+} SolverEngine;
+
+extern const char *ENGINE_NAMES[ENGINE_COUNT];
+extern SolverEngine solver_engine;            // Engine used by find_shortest_path
+extern _Thread_local long solver_expansions; // Nodes expanded by the engines on this thread since the last reset
+extern bool maze_verbose;                    // Progress messages (start and end, word order, best path), on by default
+
+// Bit-parallel BFS board of a maze (see create_bitboard)
+typedef struct Bitboard Bitboard;
+
+// Reverse breadth-first distance fields: from every cell to the end, and to both ends of every
+// word. They only depend on the maze, so they are computed once per maze and the hint arrow costs a
+// few lookups per frame. Free them (free_hint_fields) and build new ones when the maze changes.
+typedef struct
+{
+    int node_count;
+    int word_count;
+    WordPosition *word_positions;
+    int *to_end;   // to_end[cell]: steps from the cell to graph->end, INF if unreachable
+    int *to_words; // to_words[(2 * j + k) * node_count + cell]: steps to the start (k = 0) or end (k = 1) of word j
+} HintFields;
+
+// Graph
+int get_direction(int dx, int dy);
+Node *get_neighbor(Graph *graph, Node *node, int direction, int GRID_SIZE);
+Graph *create_graph(int word_count, int GRID_SIZE);
+Graph *allocate_graph(int word_count, int GRID_SIZE);
+Graph *reset_graph(Graph *graph, int word_count, int GRID_SIZE);
+void destroy_graph(Graph *graph);
+void *graph_alloc(Graph *graph, size_t size);
+void add_edge(Node *node1, Node *node2);
+void remove_edge(Node *node1, Node *node2);
+void print_neighbors(Graph *graph, int GRID_SIZE);
+void initialize_graph(Graph *graph, int GRID_SIZE);
+
+// Wall clock time in seconds, for time limits and benchmarks
+double wall_seconds(void);
+
+// Random numbers
+void seed_rng(MazeRng *rng, uint64_t seed);
+uint32_t rng_next(MazeRng *rng);
+int rng_below(MazeRng *rng, int bound);
+
+// Generation
+int load_words(const char *filename, char words[][20], int max_words);
+void place_words(Graph *graph, const char *words[], WordPosition *word_positions, int *word_count, int word_count_total, MazeRng *rng, int GRID_SIZE);
+void divide_rooms(Graph *graph, int startX, int startY, int endX, int endY, int room_size, MazeRng *rng, int GRID_SIZE);
+void divide_graph(Graph *graph, int startX, int startY, int endX, int endY, MazeRng *rng, int GRID_SIZE);
+void add_random_letters(Graph *graph, MazeRng *rng, int GRID_SIZE);
+bool set_start_end(Graph *graph, MazeRng *rng);
+
+// Solving: paths are returned as the letters along them, to be freed by the caller
+char *enlever_premier_dernier(const char *source);
+char *find_shortest_path_dijkstra(Graph *graph, Node *start, Node *end, int GRID_SIZE);
+char *find_shortest_path_bfs(Graph *graph, Node *start, Node *end, int GRID_SIZE);
+char *find_shortest_path_astar(Graph *graph, Node *start, Node *end, int GRID_SIZE);
+char *find_shortest_path_bitboard(Graph *graph, Node *start, Node *end, int GRID_SIZE);
+char *find_shortest_path_jps(Graph *graph, Node *start, Node *end, int GRID_SIZE);
+char *find_shortest_path_bidirectional(Graph *graph, Node *start, Node *end, int GRID_SIZE);
+int parse_engine(const char *name);
+char *find_shortest_path(Graph *graph, Node *start, Node *end, int GRID_SIZE);
+char *find_best_path(Graph *graph, WordPosition *word_positions, int word_count, int GRID_SIZE);
+void free_solver_scratch(void);
+Bitboard *create_bitboard(Graph *graph, int GRID_SIZE);
+void free_bitboard(Bitboard *board);
+void bitboard_distances(Bitboard *board, int source, int target, int *distances);
+
+// Playing
+void initialize_player(Player *player, Graph *graph);
+void move_player(Player *player, Graph *graph, int dx, int dy, int GRID_SIZE);
+void visit_cell(Player *player, Node *node);
+bool path_contains_word(const char *path, const char *word);
+HintFields *create_hint_fields(Graph *graph, WordPosition *word_positions, int word_count, int GRID_SIZE);
+void free_hint_fields(HintFields *hints);
+int hint_direction(HintFields *hints, Graph *graph, Player *player, int GRID_SIZE);
+int calculate_score(char *path, WordPosition *word_positions, int word_count, int best_path_length);
+
+#endif
@@ -0,0 +1,536 @@
+#define _POSIX_C_SOURCE 200809L // fileno, mmap
+#include "maze_file.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define ALIGN8(n) (((n) + 7) & ~(uint64_t)7)
+
+// Bytes of a bit plane (walls or visited)
+uint64_t plane_bytes(int GRID_SIZE)
+{
+    return (uint64_t)GRID_SIZE * MAZE_ROW_WORDS(GRID_SIZE) * sizeof(uint64_t);
+}
+
+// Header of a maze with its section offsets
+MazeFileHeader maze_file_header(Graph *graph, int word_count, bool has_player, int GRID_SIZE)
+{
+    MazeFileHeader header = {0};
+    memcpy(header.magic, MAZE_FILE_MAGIC, 4);
+    header.version = MAZE_FILE_VERSION;
+    header.grid_size = GRID_SIZE;
+    header.word_count = word_count;
+    header.start = graph->start ? graph->start - graph->nodes : 0;
+    header.end = graph->end ? graph->end - graph->nodes : 0;
+    header.flags = has_player ? MAZE_FILE_PLAYER : 0;
+    header.walls_offset = ALIGN8(sizeof(MazeFileHeader));
+    header.letters_offset = header.walls_offset + plane_bytes(GRID_SIZE);
+    header.words_offset = ALIGN8(header.letters_offset + (uint64_t)GRID_SIZE * GRID_SIZE);
+    header.size = header.words_offset + (uint64_t)word_count * sizeof(MazeFileWord);
+    if (has_player)
+    {
+        header.player_offset = ALIGN8(header.size);
+        header.size = header.player_offset + ALIGN8(sizeof(MazeFilePlayer)) + plane_bytes(GRID_SIZE);
+    }
+    return header;
+}
+
+// Write zeros until written reaches offset
+bool write_padding(FILE *file, uint64_t *written, uint64_t offset)
+{
+    static const char zeros[8] = {0};
+    if (offset - *written > sizeof(zeros) || fwrite(zeros, 1, offset - *written, file) != offset - *written)
+        return false;
+    *written = offset;
+    return true;
+}
+
+// Write a bit plane with a bit set for every node where wall (or else visited) is true
+bool write_plane(FILE *file, Graph *graph, bool walls, uint64_t *row, int GRID_SIZE)
+{
+    int row_words = MAZE_ROW_WORDS(GRID_SIZE);
+    for (int x = 0; x < GRID_SIZE; x++)
+    {
+        memset(row, 0, row_words * sizeof(uint64_t));
+        for (int y = 0; y < GRID_SIZE; y++)
+        {
+            Node *node = &graph->nodes[x * GRID_SIZE + y];
+            if (walls ? node->letter == '#' : node->visited)
+                row[y / 64] |= (uint64_t)1 << (y % 64);
+        }
+        if (fwrite(row, sizeof(uint64_t), row_words, file) != (size_t)row_words)
+            return false;
+    }
+    return true;
+}
+
+bool write_maze(FILE *file, Graph *graph, WordPosition *word_positions, int word_count, Player *player, int GRID_SIZE)
+{
+    if (GRID_SIZE > MAX_GRID_SIZE)
+    {
+        printf("Erreur : labyrinthe de %dx%d trop grand pour un fichier (%d au plus)\n", GRID_SIZE, GRID_SIZE, MAX_GRID_SIZE);
+        return false;
+    }
+
+    MazeFileHeader header = maze_file_header(graph, word_count, player != NULL, GRID_SIZE);
+    uint64_t *row = (uint64_t *)malloc(MAZE_ROW_WORDS(GRID_SIZE) * sizeof(uint64_t) + GRID_SIZE);
+    if (!row)
+    {
+        printf("Memory allocation failed.\n");
+        return false;
+    }
+    char *letters = (char *)(row + MAZE_ROW_WORDS(GRID_SIZE));
+
+    uint64_t written = sizeof(MazeFileHeader);
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 && write_padding(file, &written, header.walls_offset) &&
+              write_plane(file, graph, true, row, GRID_SIZE);
+    written = header.letters_offset;
+
+    for (int x = 0; x < GRID_SIZE && ok; x++)
+    {
+        for (int y = 0; y < GRID_SIZE; y++)
+            letters[y] = graph->nodes[x * GRID_SIZE + y].letter;
+        ok = fwrite(letters, 1, GRID_SIZE, file) == (size_t)GRID_SIZE;
+    }
+    written += (uint64_t)GRID_SIZE * GRID_SIZE;
+    ok = ok && write_padding(file, &written, header.words_offset);
+
+    for (int j = 0; j < word_count && ok; j++)
+    {
+        WordPosition *position = &word_positions[j];
+        MazeFileWord record = {position->startX, position->startY, position->endX, position->endY, position->direction, position->length, {0}};
+        strncpy(record.word, position->word, MAZE_WORD_LENGTH - 1);
+        ok = fwrite(&record, sizeof(record), 1, file) == 1;
+    }
+    written += (uint64_t)word_count * sizeof(MazeFileWord);
+
+    if (player && ok)
+    {
+        MazeFilePlayer record = {player->x, player->y, player->score, {0}, 0};
+        memcpy(record.path, player->path, sizeof(record.path));
+        ok = write_padding(file, &written, header.player_offset) && fwrite(&record, sizeof(record), 1, file) == 1;
+        written += sizeof(record);
+        ok = ok && write_padding(file, &written, header.player_offset + ALIGN8(sizeof(MazeFilePlayer))) &&
+             write_plane(file, graph, false, row, GRID_SIZE);
+    }
+    free(row);
+
+    if (!ok)
+        printf("Erreur : impossible d'écrire le labyrinthe\n");
+    return ok;
+}
+
+bool save_maze(const char *filename, Graph *graph, WordPosition *word_positions, int word_count, Player *player, int GRID_SIZE)
+{
+    FILE *file = fopen(filename, "wb");
+    if (!file)
+    {
+        printf("Erreur : impossible d'ouvrir le fichier %s\n", filename);
+        return false;
+    }
+    bool ok = write_maze(file, graph, word_positions, word_count, player, GRID_SIZE);
+    return fclose(file) == 0 && ok;
+}
+
+MazeArchiveWriter *create_maze_archive(const char *filename, uint64_t first_id, uint64_t count)
+{
+    MazeArchiveWriter *archive = (MazeArchiveWriter *)malloc(sizeof(MazeArchiveWriter));
+    MazeArchiveEntry *entries = (MazeArchiveEntry *)calloc(count ? count : 1, sizeof(MazeArchiveEntry));
+    if (!archive || !entries)
+    {
+        printf("Memory allocation failed.\n");
+        free(archive);
+        free(entries);
+        return NULL;
+    }
+
+    archive->file = fopen(filename, "wb");
+    archive->first_id = first_id;
+    archive->count = count;
+    archive->entries = entries;
+
+    // The index is written empty here and filled in by close_maze_archive
+    MazeArchiveHeader header = {{0}, MAZE_FILE_VERSION, first_id, count};
+    memcpy(header.magic, MAZE_ARCHIVE_MAGIC, 4);
+    if (!archive->file || fwrite(&header, sizeof(header), 1, archive->file) != 1 ||
+        fwrite(entries, sizeof(MazeArchiveEntry), count, archive->file) != count)
+    {
+        printf("Erreur : impossible d'écrire l'archive %s\n", filename);
+        if (archive->file)
+            fclose(archive->file);
+        free(entries);
+        free(archive);
+        return NULL;
+    }
+    return archive;
+}
+
+bool add_archive_maze(MazeArchiveWriter *archive, uint64_t id, Graph *graph, WordPosition *word_positions, int word_count, int GRID_SIZE)
+{
+    if (id < archive->first_id || id - archive->first_id >= archive->count)
+    {
+        printf("Erreur : niveau %llu hors de l'archive\n", (unsigned long long)id);
+        return false;
+    }
+
+    // Levels start 8-byte aligned, after everything written so far
+    static const char zeros[8] = {0};
+    fseek(archive->file, 0, SEEK_END);
+    long offset = ftell(archive->file);
+    if (offset < 0 || fwrite(zeros, 1, ALIGN8(offset) - offset, archive->file) != ALIGN8(offset) - offset)
+        return false;
+
+    MazeArchiveEntry *entry = &archive->entries[id - archive->first_id];
+    entry->offset = ALIGN8(offset);
+    entry->size = maze_file_header(graph, word_count, false, GRID_SIZE).size;
+    return write_maze(archive->file, graph, word_positions, word_count, NULL, GRID_SIZE);
+}
+
+bool close_maze_archive(MazeArchiveWriter *archive)
+{
+    bool ok = fseek(archive->file, sizeof(MazeArchiveHeader), SEEK_SET) == 0 &&
+              fwrite(archive->entries, sizeof(MazeArchiveEntry), archive->count, archive->file) == archive->count;
+    ok = fclose(archive->file) == 0 && ok;
+    if (!ok)
+        printf("Erreur : impossible d'écrire l'index de l'archive\n");
+    free(archive->entries);
+    free(archive);
+    return ok;
+}
+
+MazeFile *open_maze_file(const char *filename)
+{
+    MazeFile *file = (MazeFile *)calloc(1, sizeof(MazeFile));
+    if (!file)
+    {
+        printf("Memory allocation failed.\n");
+        return NULL;
+    }
+
+#ifndef _WIN32
+    // Mapped read-only: pages are read from the disk (or the page cache) when first touched
+    int descriptor = open(filename, O_RDONLY);
+    struct stat status;
+    if (descriptor >= 0 && fstat(descriptor, &status) == 0 && status.st_size > 0)
+    {
+        void *data = mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (data != MAP_FAILED)
+        {
+            file->data = (const unsigned char *)data;
+            file->size = status.st_size;
+            file->mapped = true;
+        }
+    }
+    if (descriptor >= 0)
+        close(descriptor);
+#else
+    FILE *stream = fopen(filename, "rb");
+    if (stream && fseek(stream, 0, SEEK_END) == 0)
+    {
+        long size = ftell(stream);
+        unsigned char *data = size > 0 ? (unsigned char *)malloc(size) : NULL;
+        if (data && fseek(stream, 0, SEEK_SET) == 0 && fread(data, 1, size, stream) == (size_t)size)
+        {
+            file->data = data;
+            file->size = size;
+        }
+        else
+        {
+            free(data);
+        }
+    }
+    if (stream)
+        fclose(stream);
+#endif
+
+    if (!file->data)
+    {
+        printf("Erreur : impossible d'ouvrir le fichier %s\n", filename);
+        free(file);
+        return NULL;
+    }
+
+    if (file->size >= sizeof(MazeArchiveHeader) && memcmp(file->data, MAZE_ARCHIVE_MAGIC, 4) == 0)
+    {
+        const MazeArchiveHeader *header = (const MazeArchiveHeader *)file->data;
+        file->archive = true;
+        file->first_id = header->first_id;
+        file->count = header->count;
+        if (header->version != MAZE_FILE_VERSION ||
+            header->count > (file->size - sizeof(MazeArchiveHeader)) / sizeof(MazeArchiveEntry))
+        {
+            printf("Erreur : archive invalide %s\n", filename);
+            close_maze_file(file);
+            return NULL;
+        }
+    }
+    else
+    {
+        file->count = 1;
+    }
+    return file;
+}
+
+void close_maze_file(MazeFile *file)
+{
+    if (!file)
+        return;
+
+#ifndef _WIN32
+    if (file->mapped)
+        munmap((void *)file->data, file->size);
+    else
+#endif
+        free((void *)file->data);
+    free(file);
+}
+
+// Check that a maze of size bytes at data is complete and consistent, so the view never reads
+// outside of it
+bool valid_maze(const unsigned char *data, uint64_t size)
+{
+    if (size < sizeof(MazeFileHeader))
+        return false;
+
+    const MazeFileHeader *header = (const MazeFileHeader *)data;
+    uint64_t cells = (uint64_t)header->grid_size * header->grid_size;
+    if (memcmp(header->magic, MAZE_FILE_MAGIC, 4) != 0 || header->version != MAZE_FILE_VERSION ||
+        header->grid_size < 2 || header->grid_size > MAX_GRID_SIZE || header->start >= cells || header->end >= cells ||
+        header->word_count > size / sizeof(MazeFileWord) || header->size > size)
+        return false;
+
+    // The sections must be where a writer of this version puts them
+    Graph graph = {0};
+    MazeFileHeader expected = maze_file_header(&graph, header->word_count, header->flags & MAZE_FILE_PLAYER, header->grid_size);
+    if (header->walls_offset != expected.walls_offset || header->letters_offset != expected.letters_offset ||
+        header->words_offset != expected.words_offset || header->player_offset != expected.player_offset ||
+        header->size != expected.size)
+        return false;
+
+    // Start and end are open cells
+    const uint64_t *walls = (const uint64_t *)(data + header->walls_offset);
+    int GRID_SIZE = header->grid_size;
+    if (maze_view_bit(walls, header->start / GRID_SIZE, header->start % GRID_SIZE, GRID_SIZE) ||
+        maze_view_bit(walls, header->end / GRID_SIZE, header->end % GRID_SIZE, GRID_SIZE))
+        return false;
+
+    // The letters agree with the walls: '#' on the walls and only there, and no empty cell
+    const char *letters = (const char *)(data + header->letters_offset);
+    for (int x = 0; x < GRID_SIZE; x++)
+    {
+        for (int y = 0; y < GRID_SIZE; y++)
+        {
+            char letter = letters[x * GRID_SIZE + y];
+            if (letter == '\0' || (letter == '#') != maze_view_bit(walls, x, y, GRID_SIZE))
+                return false;
+        }
+    }
+
+    // Words fit in the grid (their end is not read, graph_from_view works it out) and are written
+    // on it
+    const MazeFileWord *words = (const MazeFileWord *)(data + header->words_offset);
+    for (uint32_t j = 0; j < header->word_count; j++)
+    {
+        if (words[j].startX >= header->grid_size || words[j].startY >= header->grid_size || words[j].direction > 1 ||
+            words[j].length < 1 ||
+            words[j].length >= MAZE_WORD_LENGTH || words[j].word[words[j].length] != '\0' ||
+            (words[j].direction ? words[j].startY : words[j].startX) + words[j].length > header->grid_size)
+            return false;
+        for (uint32_t i = 0; i < words[j].length; i++)
+        {
+            int x = words[j].direction ? words[j].startX : words[j].startX + i;
+            int y = words[j].direction ? words[j].startY + i : words[j].startY;
+            if (letters[x * GRID_SIZE + y] != words[j].word[i] || maze_view_bit(walls, x, y, GRID_SIZE))
+                return false;
+        }
+    }
+
+    // The player stands on an open cell, and only open cells are visited
+    if (header->player_offset)
+    {
+        const MazeFilePlayer *player = (const MazeFilePlayer *)(data + header->player_offset);
+        const uint64_t *visited = (const uint64_t *)(data + header->player_offset + ALIGN8(sizeof(MazeFilePlayer)));
+        if (player->x < 0 || player->x >= GRID_SIZE || player->y < 0 || player->y >= GRID_SIZE ||
+            maze_view_bit(walls, player->x, player->y, GRID_SIZE))
+            return false;
+        for (size_t w = 0; w < (size_t)GRID_SIZE * MAZE_ROW_WORDS(GRID_SIZE); w++)
+        {
+            if (visited[w] & walls[w])
+                return false;
+        }
+    }
+    return true;
+}
+
+// Level id of the file: any id for a maze file (it has one level), first_id to first_id + count - 1
+// for an archive
+bool get_maze_view(MazeFile *file, uint64_t id, MazeView *view)
+{
+    const unsigned char *data = file->data;
+    uint64_t size = file->size;
+    if (file->archive)
+    {
+        if (id < file->first_id || id - file->first_id >= file->count)
+        {
+            printf("Erreur : niveau %llu absent de l'archive\n", (unsigned long long)id);
+            return false;
+        }
+        const MazeArchiveEntry *entry = (const MazeArchiveEntry *)(data + sizeof(MazeArchiveHeader)) + (id - file->first_id);
+        if (entry->offset == 0 || entry->offset % 8 || entry->offset > size || entry->size > size - entry->offset)
+        {
+            printf("Erreur : niveau %llu absent de l'archive\n", (unsigned long long)id);
+            return false;
+        }
+        data += entry->offset;
+        size = entry->size;
+    }
+
+    if (!valid_maze(data, size))
+    {
+        printf("Erreur : labyrinthe invalide\n");
+        return false;
+    }
+
+    const MazeFileHeader *header = (const MazeFileHeader *)data;
+    view->header = header;
+    view->grid_size = header->grid_size;
+    view->walls = (const uint64_t *)(data + header->walls_offset);
+    view->letters = (const char *)(data + header->letters_offset);
+    view->words = (const MazeFileWord *)(data + header->words_offset);
+    view->player = header->player_offset ? (const MazeFilePlayer *)(data + header->player_offset) : NULL;
+    view->visited = header->player_offset ? (const uint64_t *)(data + header->player_offset + ALIGN8(sizeof(MazeFilePlayer))) : NULL;
+    return true;
+}
+
+// Bit of cell (x, y) in a plane of the view
+bool maze_view_bit(const uint64_t *plane, int x, int y, int GRID_SIZE)
+{
+    return (plane[(size_t)x * MAZE_ROW_WORDS(GRID_SIZE) + y / 64] >> (y % 64)) & 1;
+}
+
+// Open cells of row x of the walls, with padding words of zeros before and after (rows outside
+// the grid and columns past its edge are closed)
+void open_row(const uint64_t *walls, int x, uint64_t *open, int GRID_SIZE)
+{
+    int row_words = MAZE_ROW_WORDS(GRID_SIZE);
+    memset(open - 1, 0, (row_words + 2) * sizeof(uint64_t));
+    if (x < 0 || x >= GRID_SIZE)
+        return;
+
+    for (int w = 0; w < row_words; w++)
+        open[w] = ~walls[(size_t)x * row_words + w];
+    if (GRID_SIZE % 64)
+        open[row_words - 1] &= ((uint64_t)1 << (GRID_SIZE % 64)) - 1;
+}
+
+Graph *graph_from_view(MazeView *view, WordPosition **word_positions)
+{
+    int GRID_SIZE = view->grid_size;
+    int row_words = MAZE_ROW_WORDS(GRID_SIZE);
+    uint64_t *rows = (uint64_t *)malloc(3 * (row_words + 2) * sizeof(uint64_t));
+    if (!rows)
+    {
+        printf("Memory allocation failed.\n");
+        return NULL;
+    }
+
+    Graph *graph = allocate_graph(view->header->word_count, GRID_SIZE);
+    if (!graph)
+    {
+        printf("Memory allocation failed.\n");
+        free(rows);
+        return NULL;
+    }
+    graph->node_count = GRID_SIZE * GRID_SIZE;
+
+    // Open neighbors 64 cells at a time: for each direction, a word with bit b set when the
+    // neighbor of cell 64 * w + b in that direction is open, from the rows above, at and below
+    uint64_t *open[3] = {rows + 1, rows + row_words + 3, rows + 2 * row_words + 5};
+    open_row(view->walls, -1, open[0], GRID_SIZE);
+    open_row(view->walls, 0, open[1], GRID_SIZE);
+    for (int x = 0; x < GRID_SIZE; x++)
+    {
+        open_row(view->walls, x + 1, open[2], GRID_SIZE);
+        for (int w = 0; w < row_words; w++)
+        {
+            uint64_t neighbor_open[DIR_COUNT];
+            for (int d = 0; d < DIR_COUNT; d++)
+            {
+                const uint64_t *row = open[1 + DIR_DX[d]];
+                neighbor_open[d] = DIR_DY[d] < 0 ? (row[w] << 1) | (row[w - 1] >> 63)
+                                   : DIR_DY[d] > 0 ? (row[w] >> 1) | (row[w + 1] << 63)
+                                                   : row[w];
+            }
+
+            for (int b = 0; b < 64 && 64 * w + b < GRID_SIZE; b++)
+            {
+                int y = 64 * w + b;
+                Node *node = &graph->nodes[x * GRID_SIZE + y];
+                unsigned char neighbors = 0;
+                if ((open[1][w] >> b) & 1)
+                {
+                    for (int d = 0; d < DIR_COUNT; d++)
+                        neighbors |= ((neighbor_open[d] >> b) & 1) << d;
+                }
+                *node = (Node){x, y, neighbors, view->letters[x * GRID_SIZE + y], false, false};
+            }
+        }
+
+        uint64_t *oldest = open[0];
+        open[0] = open[1];
+        open[1] = open[2];
+        open[2] = oldest;
+    }
+    free(rows);
+
+    uint32_t word_count = view->header->word_count;
+    *word_positions = (WordPosition *)graph_alloc(graph, (word_count + 1) * sizeof(WordPosition));
+    for (uint32_t j = 0; j < word_count; j++)
+    {
+        const MazeFileWord *record = &view->words[j];
+        char *text = (char *)graph_alloc(graph, record->length + 1);
+        if (!*word_positions || !text)
+        {
+            printf("Erreur : trop de mots dans le labyrinthe\n");
+            destroy_graph(graph);
+            return NULL;
+        }
+        memcpy(text, record->word, record->length + 1);
+        // The end follows from the start, so a damaged record cannot point outside the grid
+        int end_x = record->direction ? record->startX : record->startX + record->length - 1;
+        int end_y = record->direction ? record->startY + record->length - 1 : record->startY;
+        (*word_positions)[j] = (WordPosition){text, record->startX, record->startY, end_x, end_y, record->direction,
+                                              record->length};
+        for (uint32_t i = 0; i < record->length; i++)
+        {
+            int x = record->direction ? record->startX : record->startX + i;
+            int y = record->direction ? record->startY + i : record->startY;
+            graph->nodes[x * GRID_SIZE + y].is_part_of_word = true;
+        }
+    }
+
+    graph->start = &graph->nodes[view->header->start];
+    graph->end = &graph->nodes[view->header->end];
+    return graph;
+}
+
+bool restore_player(MazeView *view, Graph *graph, Player *player)
+{
+    int GRID_SIZE = view->grid_size;
+    if (!view->player || view->player->x < 0 || view->player->x >= GRID_SIZE || view->player->y < 0 || view->player->y >= GRID_SIZE)
+        return false;
+
+    player->x = view->player->x;
+    player->y = view->player->y;
+    player->score = view->player->score;
+    memcpy(player->path, view->player->path, sizeof(player->path));
+    player->path[sizeof(player->path) - 1] = '\0';
+
+    for (int i = 0; i < graph->node_count; i++)
+        graph->nodes[i].visited = maze_view_bit(view->visited, i / GRID_SIZE, i % GRID_SIZE, GRID_SIZE);
+    return true;
+}
@@ -0,0 +1,127 @@
+#ifndef MAZE_FILE_H
+#define MAZE_FILE_H
+
+// Binary maze files. A maze file holds one level: a header, then sections at 8-byte aligned
+// offsets from the start of the maze:
+//   walls    GRID_SIZE rows of MAZE_ROW_WORDS(GRID_SIZE) 64-bit words, bit y of row x set for a wall.
+//            Every open cell is connected to all of its open neighbors, so this is the whole graph.
+//   letters  one byte per cell, row-major
+//   words    word_count MazeFileWord records
+//   player   optional MazeFilePlayer record, then a visited plane laid out like the walls
+// An archive holds many levels: a MazeArchiveHeader, an index of count MazeArchiveEntry, then
+// the levels, each a complete maze file. Level id is at index id - first_id, so finding it is
+// one lookup. Files are read in place (mmap where available): opening one does not depend on
+// the grid size, and graph_from_view builds a playable Graph in one pass over the planes.
+// Numbers are stored in the byte order of the machine (little-endian on every supported target).
+
+#include "maze_core.h"
+
+#define MAZE_FILE_MAGIC "MAZE"
+#define MAZE_ARCHIVE_MAGIC "MZAR"
+#define MAZE_FILE_VERSION 1
+#define MAZE_FILE_PLAYER 1 // Header flag: the player section is present
+#define MAZE_WORD_LENGTH 24
+
+// 64-bit words per row of a bit plane
+#define MAZE_ROW_WORDS(GRID_SIZE) (((GRID_SIZE) + 63) / 64)
+
+typedef struct
+{
+    char magic[4]; // MAZE_FILE_MAGIC
+    uint32_t version;
+    uint32_t grid_size;
+    uint32_t word_count;
+    uint32_t start; // Cell index of the start
+    uint32_t end;   // Cell index of the end
+    uint32_t flags;
+    uint32_t reserved;
+    uint64_t size; // Bytes of the whole maze, header included
+    uint64_t walls_offset;
+    uint64_t letters_offset;
+    uint64_t words_offset;
+    uint64_t player_offset; // 0 without MAZE_FILE_PLAYER
+} MazeFileHeader;
+
+typedef struct
+{
+    uint32_t startX, startY, endX, endY;
+    uint32_t direction;
+    uint32_t length;
+    char word[MAZE_WORD_LENGTH]; // Nul-terminated
+} MazeFileWord;
+
+typedef struct
+{
+    int32_t x, y;
+    int32_t score;
+    char path[200]; // Same as Player
+    uint32_t reserved;
+} MazeFilePlayer;
+
+typedef struct
+{
+    char magic[4]; // MAZE_ARCHIVE_MAGIC
+    uint32_t version;
+    uint64_t first_id;
+    uint64_t count;
+} MazeArchiveHeader;
+
+typedef struct
+{
+    uint64_t offset; // From the start of the archive, 0 if the level was never written
+    uint64_t size;
+} MazeArchiveEntry;
+
+// One level inside an open file, pointing into its memory
+typedef struct
+{
+    const MazeFileHeader *header;
+    int grid_size;
+    const uint64_t *walls;
+    const char *letters;
+    const MazeFileWord *words;
+    const MazeFilePlayer *player; // NULL if the level has no player section
+    const uint64_t *visited;      // NULL if the level has no player section
+} MazeView;
+
+// A maze file or an archive, mapped (or read) into memory
+typedef struct
+{
+    const unsigned char *data;
+    size_t size;
+    bool mapped; // data comes from mmap, otherwise from malloc
+    bool archive;
+    uint64_t first_id; // Id of the first level (0 for a maze file)
+    uint64_t count;    // Levels (1 for a maze file)
+} MazeFile;
+
+// Writing: player may be NULL (no player section). The maze is written at the current position of
+// file, which must be a multiple of 8 bytes from the start of the file.
+bool write_maze(FILE *file, Graph *graph, WordPosition *word_positions, int word_count, Player *player, int GRID_SIZE);
+bool save_maze(const char *filename, Graph *graph, WordPosition *word_positions, int word_count, Player *player, int GRID_SIZE);
+
+// Archive of count levels with ids first_id to first_id + count - 1, written in any order
+typedef struct
+{
+    FILE *file;
+    uint64_t first_id;
+    uint64_t count;
+    MazeArchiveEntry *entries;
+} MazeArchiveWriter;
+
+MazeArchiveWriter *create_maze_archive(const char *filename, uint64_t first_id, uint64_t count);
+bool add_archive_maze(MazeArchiveWriter *archive, uint64_t id, Graph *graph, WordPosition *word_positions, int word_count, int GRID_SIZE);
+bool close_maze_archive(MazeArchiveWriter *archive); // Writes the index and frees the writer
+
+// Reading
+MazeFile *open_maze_file(const char *filename);
+void close_maze_file(MazeFile *file);
+bool get_maze_view(MazeFile *file, uint64_t id, MazeView *view);
+bool maze_view_bit(const uint64_t *plane, int x, int y, int GRID_SIZE);
+
+// Playable copies of a level: word_positions receives header->word_count entries, kept with their
+// words in the graph's arena (the file can be closed). restore_player needs a player section.
+Graph *graph_from_view(MazeView *view, WordPosition **word_positions);
+bool restore_player(MazeView *view, Graph *graph, Player *player);
+
+#endif
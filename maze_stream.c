@@ -0,0 +1,331 @@
+#include "maze_stream.h"
+
+MazeStream *create_maze_stream(int width, int capacity, const char **words, int word_total, uint64_t seed)
+{
+    if (width < 3 || capacity < 2)
+    {
+        printf("Erreur : labyrinthe sans fin de %d colonnes sur %d lignes impossible\n", width, capacity);
+        return NULL;
+    }
+
+    MazeStream *stream = (MazeStream *)calloc(1, sizeof(MazeStream));
+    if (!stream)
+    {
+        printf("Memory allocation failed.\n");
+        return NULL;
+    }
+    stream->width = width;
+    stream->capacity = capacity;
+    stream->cell_count = (width + 1) / 2;
+    stream->word_slots = capacity / 2 + 1; // At most one word per cell row kept
+
+    int n = stream->cell_count;
+    stream->nodes = (Node *)malloc((size_t)capacity * width * sizeof(Node));
+    stream->sets = (int *)malloc(n * sizeof(int));
+    stream->parents = (int *)malloc(n * sizeof(int));
+    stream->counts = (int *)malloc(n * sizeof(int));
+    stream->picks = (int *)malloc(n * sizeof(int));
+    stream->down = (bool *)malloc(n * sizeof(bool));
+    stream->go_down = (bool *)malloc(n * sizeof(bool));
+    stream->word_positions = (WordPosition *)malloc(stream->word_slots * sizeof(WordPosition));
+    stream->word_found = (bool *)malloc(stream->word_slots * sizeof(bool));
+    if (!stream->nodes || !stream->sets || !stream->parents || !stream->counts || !stream->picks || !stream->down ||
+        !stream->go_down || !stream->word_positions || !stream->word_found)
+    {
+        printf("Memory allocation failed.\n");
+        free_maze_stream(stream);
+        return NULL;
+    }
+
+    seed_rng(&stream->rng, seed);
+    stream->words = words;
+    stream->word_total = word_total;
+    for (int c = 0; c < n; c++)
+        stream->sets[c] = c; // The first row has every cell in its own set
+    return stream;
+}
+
+void free_maze_stream(MazeStream *stream)
+{
+    if (!stream)
+        return;
+
+    free(stream->nodes);
+    free(stream->sets);
+    free(stream->parents);
+    free(stream->counts);
+    free(stream->picks);
+    free(stream->down);
+    free(stream->go_down);
+    free(stream->word_positions);
+    free(stream->word_found);
+    free(stream);
+}
+
+int stream_first_row(MazeStream *stream)
+{
+    return stream->next_row > stream->capacity ? stream->next_row - stream->capacity : 0;
+}
+
+Node *stream_row(MazeStream *stream, int row)
+{
+    if (row < stream_first_row(stream) || row >= stream->next_row)
+        return NULL;
+    return &stream->nodes[(size_t)(row % stream->capacity) * stream->width];
+}
+
+Node *stream_cell(MazeStream *stream, int x, int y)
+{
+    if (y < 0 || y >= stream->width)
+        return NULL;
+    Node *row = stream_row(stream, x);
+    return row ? &row[y] : NULL;
+}
+
+WordPosition *stream_word(MazeStream *stream, int index)
+{
+    if (index < 0 || index >= stream->word_count || index < stream->word_count - stream->word_slots)
+        return NULL;
+    WordPosition *word = &stream->word_positions[index % stream->word_slots];
+    return word->startX >= stream_first_row(stream) ? word : NULL;
+}
+
+// Root of a set, halving the path on the way
+int find_set(int *parents, int set)
+{
+    while (parents[set] != set)
+        set = parents[set] = parents[parents[set]];
+    return set;
+}
+
+// Write a random word across a cell row, somewhere it fits
+void place_stream_word(MazeStream *stream, Node *nodes)
+{
+    const char *word = stream->words[rng_below(&stream->rng, stream->word_total)];
+    int length = strlen(word);
+    if (length == 0 || length > stream->width)
+        return;
+
+    int start = rng_below(&stream->rng, stream->width - length + 1);
+    for (int i = 0; i < length; i++)
+    {
+        nodes[start + i].letter = word[i];
+        nodes[start + i].is_part_of_word = true;
+    }
+    int row = nodes[0].x;
+    stream->word_positions[stream->word_count % stream->word_slots] =
+        (WordPosition){word, row, start, row, start + length - 1, 1, length};
+    stream->word_found[stream->word_count % stream->word_slots] = false;
+    stream->word_count++;
+}
+
+// Even row: the cells, with the walls between the ones that are not joined
+void make_cell_row(MazeStream *stream, Node *nodes)
+{
+    // A word across the row, now and then
+    if (stream->word_total > 0 && rng_below(&stream->rng, STREAM_WORD_CHANCE) == 0)
+        place_stream_word(stream, nodes);
+
+    int *sets = stream->sets, *parents = stream->parents;
+    for (int s = 0; s < stream->cell_count; s++)
+        parents[s] = s;
+    for (int c = 0; c + 1 < stream->cell_count; c++)
+    {
+        Node *wall = &nodes[2 * c + 1];
+        int left = find_set(parents, sets[c]), right = find_set(parents, sets[c + 1]);
+
+        // A letter keeps the wall open, otherwise different sets are joined half of the time
+        if (wall->letter != ' ' || (left != right && rng_below(&stream->rng, 2) == 0))
+            parents[right] = left;
+        else
+            wall->letter = '#';
+    }
+    if (stream->width % 2 == 0 && nodes[stream->width - 1].letter == ' ')
+        nodes[stream->width - 1].letter = '#'; // Last column of an even width, with no cell on its right
+
+    for (int c = 0; c < stream->cell_count; c++)
+        sets[c] = find_set(parents, sets[c]);
+}
+
+// Odd row: the passages down from the cells above, at least one per set
+void make_passage_row(MazeStream *stream, Node *nodes)
+{
+    int *sets = stream->sets, *counts = stream->counts, *picks = stream->picks;
+    bool *down = stream->down, *go_down = stream->go_down;
+    for (int s = 0; s < stream->cell_count; s++)
+    {
+        counts[s] = 0;
+        go_down[s] = false;
+    }
+    for (int c = 0; c < stream->cell_count; c++)
+    {
+        int s = sets[c];
+        counts[s]++;
+        if (rng_below(&stream->rng, counts[s]) == 0)
+            picks[s] = c; // Each cell of the set as likely to be picked
+        down[c] = rng_below(&stream->rng, 2) == 0;
+        go_down[s] = go_down[s] || down[c];
+    }
+    for (int c = 0; c < stream->cell_count; c++)
+    {
+        if (!go_down[sets[c]])
+        {
+            down[picks[sets[c]]] = true;
+            go_down[sets[c]] = true;
+        }
+    }
+
+    for (int y = 0; y < stream->width; y++)
+        nodes[y].letter = y % 2 == 0 && down[y / 2] ? ' ' : '#';
+
+    // Sets of the next cell row: a cell below a passage stays in the set above, the others start
+    // their own. Sets are numbered again from 0, so there are never more than cells.
+    int *numbers = stream->parents;
+    for (int s = 0; s < stream->cell_count; s++)
+        numbers[s] = -1;
+    int next = 0;
+    for (int c = 0; c < stream->cell_count; c++)
+    {
+        if (down[c])
+        {
+            if (numbers[sets[c]] < 0)
+                numbers[sets[c]] = next++;
+            sets[c] = numbers[sets[c]];
+        }
+    }
+    for (int c = 0; c < stream->cell_count; c++)
+    {
+        if (!down[c])
+            sets[c] = next++;
+    }
+}
+
+// Connect the open cells of a row with their open neighbors in the row and in the row above, and
+// cut the oldest row kept from the row the new one replaced. Walls are random, so edges are
+// computed rather than branched on, and each node is written once.
+void link_row(MazeStream *stream, int row)
+{
+    Node *nodes = stream_row(stream, row), *above = stream_row(stream, row - 1);
+    int width = stream->width;
+    int left = get_direction(0, -1), right = get_direction(0, 1);
+    int up_left = get_direction(-1, -1), up = get_direction(-1, 0), up_right = get_direction(-1, 1);
+
+    for (int y = 0; y < width; y++)
+    {
+        // Open cells around, 0 outside the grid
+        int open = nodes[y].letter != '#';
+        int open_left = y > 0 ? nodes[y - 1].letter != '#' : 0;
+        int open_right = y + 1 < width ? nodes[y + 1].letter != '#' : 0;
+        nodes[y].neighbors |= (open & open_left) << left | (open & open_right) << right;
+        if (!above)
+            continue;
+
+        int open_above = above[y].letter != '#';
+        int open_up_left = y > 0 ? above[y - 1].letter != '#' : 0;
+        int open_up_right = y + 1 < width ? above[y + 1].letter != '#' : 0;
+        nodes[y].neighbors |= (open & open_up_left) << up_left | (open & open_above) << up | (open & open_up_right) << up_right;
+        above[y].neighbors |= (open_above & open_left) << (DIR_COUNT - 1 - up_right) |
+                              (open_above & open) << (DIR_COUNT - 1 - up) |
+                              (open_above & open_right) << (DIR_COUNT - 1 - up_left);
+    }
+
+    int first = stream_first_row(stream);
+    if (first > 0)
+    {
+        Node *oldest = stream_row(stream, first);
+        unsigned char upwards = (1 << up_left) | (1 << up) | (1 << up_right);
+        for (int y = 0; y < width; y++)
+            oldest[y].neighbors &= ~upwards;
+    }
+}
+
+// Make the next row, in place of the oldest one once the ring is full
+void stream_next_row(MazeStream *stream)
+{
+    int row = stream->next_row;
+    Node *nodes = &stream->nodes[(size_t)(row % stream->capacity) * stream->width];
+    for (int y = 0; y < stream->width; y++)
+        nodes[y] = (Node){row, y, 0, ' ', false, false};
+
+    if (row % 2 == 0)
+        make_cell_row(stream, nodes);
+    else
+        make_passage_row(stream, nodes);
+
+    // Random letters on the open cells left
+    for (int y = 0; y < stream->width; y++)
+    {
+        if (nodes[y].letter == ' ')
+            nodes[y].letter = 'A' + rng_below(&stream->rng, 26);
+    }
+
+    stream->next_row++;
+    link_row(stream, row);
+}
+
+void fill_stream(MazeStream *stream, int last_row)
+{
+    while (stream->next_row <= last_row)
+        stream_next_row(stream);
+}
+
+// Start at the first cell of the first row
+void initialize_stream_player(Player *player, MazeStream *stream)
+{
+    fill_stream(stream, 1);
+    player->x = 0;
+    player->y = 0;
+    player->score = 0;
+    player->path[0] = '\0';
+}
+
+void move_stream_player(Player *player, MazeStream *stream, int dx, int dy)
+{
+    int direction = get_direction(dx, dy);
+    Node *current = stream_cell(stream, player->x, player->y);
+
+    // The move is allowed only if the edge in that direction is open (there is none to rows gone)
+    if (!current || direction < 0 || !(current->neighbors & (1 << direction)))
+        return;
+
+    Node *node = stream_cell(stream, player->x + dx, player->y + dy);
+    if (!node)
+        return;
+
+    // The path of an endless game keeps its latest letters, so words can still be spelled once it is full
+    size_t length = strlen(player->path);
+    if (length >= sizeof(player->path) - 1)
+        memmove(player->path, player->path + length / 2, length - length / 2 + 1);
+    visit_cell(player, node);
+}
+
+// Word the player has just spelled, if any: standing on one of its ends, with its letters last in the
+// path, in either direction. Scores 3 points a letter (as calculate_score does), once per word.
+WordPosition *spell_stream_word(MazeStream *stream, Player *player)
+{
+    int path_length = strlen(player->path);
+    for (int i = stream->word_count - 1; i >= 0 && i >= stream->word_count - stream->word_slots; i--)
+    {
+        WordPosition *word = stream_word(stream, i);
+        if (!word || word->startX != player->x || stream->word_found[i % stream->word_slots] || path_length < word->length)
+            continue;
+
+        const char *tail = player->path + path_length - word->length;
+        bool spelled = false;
+        if (player->y == word->endY) // Read from its first letter
+            spelled = strncmp(tail, word->word, word->length) == 0;
+        if (!spelled && player->y == word->startY) // Read backwards
+        {
+            spelled = true;
+            for (int k = 0; k < word->length && spelled; k++)
+                spelled = tail[k] == word->word[word->length - 1 - k];
+        }
+        if (spelled)
+        {
+            stream->word_found[i % stream->word_slots] = true;
+            player->score += word->length * 3;
+            return word;
+        }
+    }
+    return NULL;
+}
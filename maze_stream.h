@@ -0,0 +1,62 @@
+#ifndef MAZE_STREAM_H
+#define MAZE_STREAM_H
+
+// Endless mazes, built one row at a time with Eller's algorithm, for the survival mode. Rows are
+// numbered from 0 downwards and kept in a ring of capacity rows: making a row replaces the oldest
+// one, so memory only depends on the width, however far down the maze goes.
+// The maze cells of Eller's algorithm are the even columns of the even rows. The odd columns of an
+// even row are the walls between two cells, and an odd row holds the passages down (even columns)
+// between pillars (odd columns). Each cell row is made from the sets of the row above:
+//   across  two neighboring cells of different sets are joined (one set) half of the time
+//   down    each cell goes down half of the time, and every set goes down at least once
+// so every cell is connected to the rows below and the maze never closes. The state of the sets is
+// one row of cells: O(width), like the ring.
+// Words are written across a cell row before its walls (walls never cover a letter, which joins the
+// cells on both sides), then the open cells left get random letters, as in a generated maze. A word
+// scores when the player spells it (see spell_stream_word).
+
+#include "maze_core.h"
+
+#define STREAM_WORD_CHANCE 3 // One cell row in STREAM_WORD_CHANCE gets a word
+
+typedef struct
+{
+    int width;    // Columns
+    int capacity; // Rows kept
+    int next_row; // Row made next
+    Node *nodes;  // Ring of rows: row r at (r % capacity) * width, its nodes with x = r
+    MazeRng rng;
+
+    // Eller's state, one entry per cell of a row (the even columns)
+    int cell_count;
+    int *sets;     // Set of each cell of the current cell row, from 0 to cell_count - 1
+    int *parents;  // Union-find over the sets while joining cells across
+    int *counts;   // Cells of each set, while choosing the passages down
+    int *picks;    // Cell of each set going down if no other does
+    bool *down;    // Cells with a passage down
+    bool *go_down; // Sets with a passage down
+
+    // Words, placed from a list owned by the caller
+    const char **words;
+    int word_total;
+    WordPosition *word_positions; // Ring of the words of the kept rows, by cell row
+    bool *word_found;             // Same ring: the word has been spelled
+    int word_slots;
+    int word_count; // Words placed so far
+} MazeStream;
+
+MazeStream *create_maze_stream(int width, int capacity, const char **words, int word_total, uint64_t seed);
+void free_maze_stream(MazeStream *stream);
+void stream_next_row(MazeStream *stream);
+void fill_stream(MazeStream *stream, int last_row); // Make rows until last_row exists
+int stream_first_row(MazeStream *stream);           // Oldest row kept
+Node *stream_row(MazeStream *stream, int row);      // First node of a row, NULL if it is not kept
+Node *stream_cell(MazeStream *stream, int x, int y);
+WordPosition *stream_word(MazeStream *stream, int index); // Word index (0 for the first placed), NULL if gone
+
+// Playing
+void initialize_stream_player(Player *player, MazeStream *stream);
+void move_stream_player(Player *player, MazeStream *stream, int dx, int dy);
+WordPosition *spell_stream_word(MazeStream *stream, Player *player);
+
+#endif
@@ -0,0 +1,136 @@
+#include "maze_core.h"
+
+// Headless solver benchmark: times every shortest path engine on generated mazes.
+// Usage: solver_bench [--engine=name] (only that engine, every engine by default)
+
+// Solve runs times between the start and end cells with the selected engine, elapsed receives the
+// seconds taken. Returns "yes" if every path matches the reference, "length" if they only have
+// its length, "NO" otherwise.
+const char *benchmark_engine(Graph *graph, const char *reference, int runs, double *elapsed, int GRID_SIZE)
+{
+    bool same = true, same_length = true;
+    free(find_shortest_path(graph, graph->start, graph->end, GRID_SIZE)); // Warm up, not timed
+    solver_expansions = 0;
+    clock_t begin = clock();
+    for (int r = 0; r < runs; r++)
+    {
+        char *path = find_shortest_path(graph, graph->start, graph->end, GRID_SIZE);
+        same = same && (path == reference || (path && reference && strcmp(path, reference) == 0));
+        same_length = same_length && (path == reference || (path && reference && strlen(path) == strlen(reference)));
+        free(path);
+    }
+    *elapsed = (double)(clock() - begin) / CLOCKS_PER_SEC;
+    return same ? "yes" : same_length ? "length" : "NO";
+}
+
+// Time every engine (or only engine, if it is not -1) between the start and end cells for growing
+// grid sizes, then on a large grid with rooms of growing size
+int run_solver_benchmark(int engine)
+{
+    int sizes[] = {10, 15, 18, 32, 64, 128, 256, 512, 1024};
+    int size_count = sizeof(sizes) / sizeof(sizes[0]);
+
+    MazeRng rng;
+    seed_rng(&rng, 42); // Same mazes on every run
+    printf("grid\tcells\tpath\tengine\tus/solve\texpanded\tsame path\n");
+    for (int s = 0; s < size_count; s++)
+    {
+        int GRID_SIZE = sizes[s];
+        Graph *graph = create_graph(0, GRID_SIZE);
+        initialize_graph(graph, GRID_SIZE);
+        divide_graph(graph, 0, 0, GRID_SIZE - 1, GRID_SIZE - 1, &rng, GRID_SIZE);
+        add_random_letters(graph, &rng, GRID_SIZE);
+        if (!set_start_end(graph, &rng))
+        {
+            printf("Erreur : pas de départ et d'arrivée assez éloignés dans la grille de %d\n", GRID_SIZE);
+            destroy_graph(graph);
+            continue;
+        }
+
+        int runs = 2000000 / graph->node_count + 1; // Fewer runs on the big grids
+        char *reference = find_shortest_path_dijkstra(graph, graph->start, graph->end, GRID_SIZE);
+
+        for (int e = 0; e < ENGINE_COUNT; e++)
+        {
+            if (engine >= 0 && e != engine)
+                continue;
+            solver_engine = e;
+            double elapsed;
+            const char *same = benchmark_engine(graph, reference, runs, &elapsed, GRID_SIZE);
+            printf("%d\t%d\t%d\t%s\t%.2f\t%ld\t%s\n", GRID_SIZE, graph->node_count, reference ? (int)strlen(reference) : 0,
+                   ENGINE_NAMES[e], elapsed * 1e6 / runs, solver_expansions / runs, same);
+        }
+        free(reference);
+
+        // Complete distance fields with a reused board, the way batch analysis runs them
+        bool fields = engine < 0 || engine == ENGINE_BITBOARD;
+        Bitboard *board = fields ? create_bitboard(graph, GRID_SIZE) : NULL;
+        int *distances = fields ? (int *)malloc(graph->node_count * sizeof(int)) : NULL;
+        if (board && distances)
+        {
+            clock_t begin = clock();
+            for (int r = 0; r < runs; r++)
+                bitboard_distances(board, graph->start - graph->nodes, -1, distances);
+            double elapsed = (double)(clock() - begin) / CLOCKS_PER_SEC;
+            printf("%d\t%d\t-\tfield\t%.2f\t-\t-\n", GRID_SIZE, graph->node_count, elapsed * 1e6 / runs);
+        }
+        free(distances);
+        free_bitboard(board);
+        destroy_graph(graph);
+    }
+
+    // Open rooms: divide_rooms stops at rooms of the given size instead of corridors
+    int rooms[] = {2, 8, 32, 128, 1024};
+    int room_count = sizeof(rooms) / sizeof(rooms[0]);
+    printf("\ngrid\troom\tpath\tengine\tus/solve\texpanded\tsame path\n");
+    for (int s = 0; s < room_count; s++)
+    {
+        int GRID_SIZE = 512;
+        Graph *graph = create_graph(0, GRID_SIZE);
+        initialize_graph(graph, GRID_SIZE);
+        divide_rooms(graph, 0, 0, GRID_SIZE - 1, GRID_SIZE - 1, rooms[s], &rng, GRID_SIZE);
+        add_random_letters(graph, &rng, GRID_SIZE);
+        if (!set_start_end(graph, &rng))
+        {
+            printf("Erreur : pas de départ et d'arrivée assez éloignés dans la grille de %d\n", GRID_SIZE);
+            destroy_graph(graph);
+            continue;
+        }
+
+        int runs = 5;
+        char *reference = find_shortest_path_dijkstra(graph, graph->start, graph->end, GRID_SIZE);
+        for (int e = 0; e < ENGINE_COUNT; e++)
+        {
+            if (engine >= 0 && e != engine)
+                continue;
+            solver_engine = e;
+            double elapsed;
+            const char *same = benchmark_engine(graph, reference, runs, &elapsed, GRID_SIZE);
+            printf("%d\t%d\t%d\t%s\t%.2f\t%ld\t%s\n", GRID_SIZE, rooms[s], reference ? (int)strlen(reference) : 0,
+                   ENGINE_NAMES[e], elapsed * 1e6 / runs, solver_expansions / runs, same);
+        }
+        free(reference);
+        destroy_graph(graph);
+    }
+    return 0;
+}
+
+int main(int argc, char *args[])
+{
+    int only = -1;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(args[i], "--engine=", 9) == 0)
+        {
+            int engine = parse_engine(args[i] + 9);
+            if (engine < 0)
+            {
+                printf("Erreur : moteur inconnu %s\n", args[i] + 9);
+                return 1;
+            }
+            only = engine;
+        }
+    }
+    maze_verbose = false; // Only the tables
+    return run_solver_benchmark(only);
+}